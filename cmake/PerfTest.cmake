@@ -0,0 +1,124 @@
+# Performance regression test, run in script mode by CTest:
+#
+#   cmake -DNAME=<name> -DEXECUTABLE=<path> -DARGS=<arg1|arg2|...> -DPATTERN=<regex>
+#         -DBASELINE=<file> [-DTOLERANCE=<percent>] [-DREPEAT=<count>] [-DUPDATE=ON -DOUTPUT=<file>]
+#         -P PerfTest.cmake
+#
+# The executable is run REPEAT times and the best time is kept,
+# where the time in seconds is the first group captured by PATTERN.
+# The test fails if this time exceeds the baseline by more than TOLERANCE percent.
+# The baseline file contains lines `<name> <seconds>`, and `#` starts a comment.
+# The test fails, too, if it is not found in the baseline.
+# If UPDATE is set, the time is written to OUTPUT instead, which is initialized with the baseline,
+# such that the updated file can be reviewed and copied over the baseline.
+
+if(NOT DEFINED TOLERANCE)
+  set(TOLERANCE 20)
+endif()
+if(NOT DEFINED REPEAT)
+  set(REPEAT 3)
+endif()
+string(REPLACE "|" ";" ARGS "${ARGS}")
+
+# Convert a decimal or scientific number of seconds to an integer number of nanoseconds
+function(to_nanoseconds seconds out)
+  if(NOT seconds MATCHES "^([0-9]*)\\.?([0-9]*)[eE]?([-+]?[0-9]*)$")
+    message(FATAL_ERROR "Invalid time: ${seconds}")
+  endif()
+  set(digits "${CMAKE_MATCH_1}${CMAKE_MATCH_2}")
+  string(LENGTH "${CMAKE_MATCH_2}" decimals)
+  set(exponent "${CMAKE_MATCH_3}")
+  if(exponent STREQUAL "")
+    set(exponent 0)
+  endif()
+  math(EXPR shift "${exponent} + 9 - ${decimals}")
+  if(shift GREATER_EQUAL 0)
+    string(REPEAT "0" ${shift} zeros)
+    set(digits "${digits}${zeros}")
+  else()
+    string(LENGTH "${digits}" length)
+    math(EXPR length "${length} + ${shift}")
+    if(length LESS_EQUAL 0)
+      set(digits 0)
+    else()
+      string(SUBSTRING "${digits}" 0 ${length} digits)
+    endif()
+  endif()
+  string(REGEX MATCH "^0*([0-9]+)$" digits "${digits}") # Strip leading zeros
+  set(${out} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+# Run the benchmark
+
+set(best "")
+foreach(run RANGE 1 ${REPEAT})
+  execute_process(
+    COMMAND ${EXECUTABLE} ${ARGS}
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE error
+    RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${EXECUTABLE} failed (${result}):\n${output}\n${error}")
+  endif()
+  if(NOT output MATCHES "${PATTERN}")
+    message(FATAL_ERROR "Cannot find '${PATTERN}' in the output of ${EXECUTABLE}:\n${output}")
+  endif()
+  to_nanoseconds("${CMAKE_MATCH_1}" time)
+  if(best STREQUAL "" OR time LESS best)
+    set(best ${time})
+  endif()
+endforeach()
+
+# Read the baseline
+
+set(baseline "")
+set(lines "")
+if(EXISTS "${BASELINE}")
+  file(STRINGS "${BASELINE}" lines)
+endif()
+foreach(line IN LISTS lines)
+  if(line MATCHES "^${NAME}[ \t]+([0-9.eE+-]+)")
+    to_nanoseconds("${CMAKE_MATCH_1}" baseline)
+  endif()
+endforeach()
+
+# Update or compare
+
+math(EXPR best_us "${best} / 1000")
+if(UPDATE)
+  if(EXISTS "${OUTPUT}")
+    file(STRINGS "${OUTPUT}" lines)
+  endif()
+  set(updated "")
+  foreach(line IN LISTS lines)
+    if(NOT line MATCHES "^${NAME}[ \t]")
+      string(APPEND updated "${line}\n")
+    endif()
+  endforeach()
+  math(EXPR seconds "${best} / 1000000000")
+  math(EXPR fraction "${best} % 1000000000")
+  string(LENGTH "${fraction}" length)
+  math(EXPR length "9 - ${length}")
+  string(REPEAT "0" ${length} zeros)
+  string(APPEND updated "${NAME} ${seconds}.${zeros}${fraction}\n")
+  file(WRITE "${OUTPUT}" "${updated}")
+  message(STATUS "${NAME}: ${best_us} us, written to ${OUTPUT}")
+  return()
+endif()
+
+if(baseline STREQUAL "")
+  message(
+    FATAL_ERROR
+      "${NAME}: ${best_us} us, but no baseline in ${BASELINE}\n"
+      "Generate it on the reference machine with LINX_PERF_UPDATE=ON, and copy it from ${OUTPUT}")
+endif()
+
+math(EXPR limit "${baseline} * (100 + ${TOLERANCE}) / 100")
+math(EXPR baseline_us "${baseline} / 1000")
+math(EXPR ratio "100 * ${best} / ${baseline}")
+if(best GREATER limit)
+  message(
+    FATAL_ERROR
+      "${NAME}: ${best_us} us is ${ratio}% of the baseline (${baseline_us} us), above the ${TOLERANCE}% tolerance")
+endif()
+message(STATUS "${NAME}: ${best_us} us is ${ratio}% of the baseline (${baseline_us} us)")
@@ -6,9 +6,11 @@
 #define _LINXBASE_ALGORITHM_H
 
 #include "Linx/Base/Functional.h"
+#include "Linx/Base/Instrumentation.h"
 #include "Linx/Base/Types.h"
 
 #include <algorithm> // min
+#include <cstdint>
 #include <numeric> // midpoint
 
 namespace Linx {
@@ -18,22 +20,264 @@ namespace Linx {
  * 
  * While `std::nth_element()` typically relies on introselect, this function implements insertion-sort,
  * which has higher complexity but should be faster for small arrays, which is typically the case for rank-filtering.
+ * 
+ * @see `select_n()` for larger arrays
  */
 template <typename TInOut>
-const auto& sort_n(TInOut& in_out, Index n)
+KOKKOS_INLINE_FUNCTION const auto& sort_n(TInOut& in_out, Index n)
+{
+  return sort_n(in_out, n, NoCounters());
+}
+
+/**
+ * @copydoc sort_n()
+ * 
+ * The branch outcomes of the inner loop are counted as `Counter::SortShifts` and `Counter::SortStops`.
+ */
+template <typename TInOut, typename TCounters>
+KOKKOS_INLINE_FUNCTION const auto& sort_n(TInOut& in_out, Index n, const TCounters& counters)
 {
   using T = std::remove_cvref_t<decltype(in_out[0])>;
   T current;
   std::size_t j;
+  std::uint64_t shifts = 0;
+  std::uint64_t stops = 0;
   for (std::size_t i = 0; i < in_out.size(); ++i) {
     j = std::min<std::size_t>(i, n + 1);
     current = in_out[i];
     in_out[i] = in_out[j];
     for (; j > 0 && current < in_out[j - 1]; --j) {
       in_out[j] = in_out[j - 1];
+      if constexpr (not std::is_same_v<TCounters, NoCounters>) {
+        ++shifts;
+      }
+    }
+    in_out[j] = current;
+    if constexpr (not std::is_same_v<TCounters, NoCounters>) {
+      stops += (j > 0);
+    }
+  }
+  counters.add(Counter::SortShifts, shifts);
+  counters.add(Counter::SortStops, stops);
+  return in_out[n];
+}
+
+namespace Impl {
+
+/**
+ * @brief The first elements of an array.
+ */
+template <typename TArray>
+struct Prefix {
+  TArray& m_values; ///< The array
+  std::size_t m_size; ///< The prefix size
+
+  /**
+   * @brief The prefix size.
+   */
+  KOKKOS_INLINE_FUNCTION std::size_t size() const
+  {
+    return m_size;
+  }
+
+  /**
+   * @brief Access an element.
+   */
+  KOKKOS_INLINE_FUNCTION decltype(auto) operator[](std::size_t i) const
+  {
+    return m_values[i];
+  }
+};
+
+/**
+ * @brief The maximum array size for which `select_n()` relies on `sort_n()`.
+ */
+constexpr std::size_t select_insertion_max = 8;
+
+/**
+ * @brief The maximum array size for which `select_n()` relies on a sorting network.
+ */
+constexpr std::size_t select_network_max = 32;
+
+/**
+ * @brief Swap two elements.
+ */
+template <typename TInOut>
+KOKKOS_INLINE_FUNCTION void swap_elements(TInOut& in_out, std::size_t i, std::size_t j)
+{
+  const auto tmp = in_out[i];
+  in_out[i] = in_out[j];
+  in_out[j] = tmp;
+}
+
+/**
+ * @brief Sort an array with Batcher's odd-even merge sorting network.
+ * 
+ * The sequence of comparisons only depends on the array size, which avoids branch mispredictions and warp divergence.
+ * Compare-exchanges which swap or keep the elements are counted as `Counter::SortShifts` and `Counter::SortStops`.
+ */
+template <typename TInOut, typename TCounters>
+KOKKOS_INLINE_FUNCTION void network_sort(TInOut& in_out, std::size_t size, const TCounters& counters)
+{
+  std::uint64_t swaps = 0;
+  std::uint64_t keeps = 0;
+  for (std::size_t p = 1; p < size; p <<= 1) {
+    for (std::size_t k = p; k >= 1; k >>= 1) {
+      for (std::size_t j = k % p; j + k < size; j += 2 * k) {
+        for (std::size_t i = 0; i < k && i + j + k < size; ++i) {
+          if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+            const auto lhs = in_out[i + j];
+            const auto rhs = in_out[i + j + k];
+            const bool swap = rhs < lhs;
+            in_out[i + j] = swap ? rhs : lhs;
+            in_out[i + j + k] = swap ? lhs : rhs;
+            if constexpr (not std::is_same_v<TCounters, NoCounters>) {
+              swaps += swap;
+              keeps += not swap;
+            }
+          }
+        }
+      }
+    }
+  }
+  counters.add(Counter::SortShifts, swaps);
+  counters.add(Counter::SortStops, keeps);
+}
+
+/**
+ * @brief Sort a range of an array with heap sort.
+ * 
+ * This is the fallback of `introselect()` when partitioning degenerates.
+ */
+template <typename TInOut>
+KOKKOS_INLINE_FUNCTION void heap_sort(TInOut& in_out, std::size_t begin, std::size_t end)
+{
+  const auto size = end - begin;
+  const auto sift_down = [&](std::size_t root, std::size_t stop) {
+    while (2 * root + 1 < stop) {
+      auto child = 2 * root + 1;
+      if (child + 1 < stop && in_out[begin + child] < in_out[begin + child + 1]) {
+        ++child;
+      }
+      if (not(in_out[begin + root] < in_out[begin + child])) {
+        return;
+      }
+      swap_elements(in_out, begin + root, begin + child);
+      root = child;
+    }
+  };
+  for (auto i = size / 2; i > 0; --i) {
+    sift_down(i - 1, size);
+  }
+  for (auto stop = size; stop > 1; --stop) {
+    swap_elements(in_out, begin, begin + stop - 1);
+    sift_down(0, stop - 1);
+  }
+}
+
+/**
+ * @brief Partition an array around its `n`-th value with introselect.
+ * 
+ * Quickselect with median-of-three pivots is used,
+ * until the range is small enough for insertion sort or the recursion depth exceeds `2 log2(size)`,
+ * in which case the remaining range is heap-sorted.
+ */
+template <typename TInOut>
+KOKKOS_INLINE_FUNCTION void introselect(TInOut& in_out, std::size_t n)
+{
+  std::size_t begin = 0;
+  std::size_t end = in_out.size();
+  int depth = 0;
+  for (auto size = end; size > 1; size >>= 1) {
+    depth += 2;
+  }
+  while (end - begin > select_insertion_max) {
+    if (depth-- == 0) {
+      heap_sort(in_out, begin, end);
+      return;
+    }
+
+    // Median-of-three pivot, moved to end - 1
+    const auto mid = begin + (end - begin) / 2;
+    if (in_out[mid] < in_out[begin]) {
+      swap_elements(in_out, mid, begin);
+    }
+    if (in_out[end - 1] < in_out[begin]) {
+      swap_elements(in_out, end - 1, begin);
+    }
+    if (in_out[mid] < in_out[end - 1]) {
+      swap_elements(in_out, mid, end - 1);
+    }
+    const auto pivot = in_out[end - 1];
+
+    // Lomuto partition
+    auto store = begin;
+    for (auto i = begin; i < end - 1; ++i) {
+      if (in_out[i] < pivot) {
+        swap_elements(in_out, i, store);
+        ++store;
+      }
+    }
+    swap_elements(in_out, store, end - 1);
+
+    if (n == store) {
+      return;
+    } else if (n < store) {
+      end = store;
+    } else {
+      begin = store + 1;
+    }
+  }
+
+  // Insertion sort of the remaining range
+  for (auto i = begin + 1; i < end; ++i) {
+    const auto current = in_out[i];
+    auto j = i;
+    for (; j > begin && current < in_out[j - 1]; --j) {
+      in_out[j] = in_out[j - 1];
     }
     in_out[j] = current;
   }
+}
+
+} // namespace Impl
+
+/**
+ * @brief Select the `n`-th smallest value of an array.
+ * 
+ * The algorithm depends on the array size:
+ * - up to `Impl::select_insertion_max` elements, `sort_n()` is used;
+ * - up to `Impl::select_network_max` elements, the array is sorted with a sorting network;
+ * - otherwise, introselect is used.
+ * 
+ * In all cases, on return, the elements before (resp. after) the `n`-th element are lower (resp. greater) or equal,
+ * like with `std::nth_element()`, but they are not necessarily sorted.
+ * 
+ * @warning Elements of `in_out` are shuffled (partially sorted).
+ */
+template <typename TInOut>
+KOKKOS_INLINE_FUNCTION const auto& select_n(TInOut& in_out, Index n)
+{
+  return select_n(in_out, n, NoCounters());
+}
+
+/**
+ * @copydoc select_n()
+ * 
+ * The branch outcomes of `sort_n()` and the compare-exchanges of the sorting network are counted.
+ */
+template <typename TInOut, typename TCounters>
+KOKKOS_INLINE_FUNCTION const auto& select_n(TInOut& in_out, Index n, const TCounters& counters)
+{
+  const std::size_t size = in_out.size();
+  if (size <= Impl::select_insertion_max) {
+    return sort_n(in_out, n, counters);
+  }
+  if (size <= Impl::select_network_max) {
+    Impl::network_sort(in_out, size, counters);
+  } else {
+    Impl::introselect(in_out, n);
+  }
   return in_out[n];
 }
 
@@ -43,27 +287,42 @@ const auto& sort_n(TInOut& in_out, Index n)
  * 
  * This function simply picks `median_even()` or `median_odd()` depending on the array size.
  * 
- * If the array size is odd, the median is computed as the arithmetic mean of the `n`-th and `n + 1`-th elements of the array,
+ * If the array size is even, the median is computed as the arithmetic mean of the `n`-th and `n + 1`-th elements of the array,
  * where `n` is half the size of the array.
  * 
  * @warning Elements of `in_out` are shuffled (partially sorted).
  */
 template <typename TParity = Forward, typename TInOut>
-auto median(TInOut& in_out)
+KOKKOS_INLINE_FUNCTION auto median(TInOut& in_out)
+{
+  return median<TParity>(in_out, NoCounters());
+}
+
+/**
+ * @copydoc median()
+ * 
+ * The branch outcomes of `select_n()` are counted.
+ */
+template <typename TParity = Forward, typename TInOut, typename TCounters>
+KOKKOS_INLINE_FUNCTION auto median(TInOut& in_out, const TCounters& counters)
 {
   const auto size = in_out.size();
 
   if constexpr (std::is_same_v<TParity, OddNumber>) {
-    return sort_n(in_out, in_out.size() / 2);
+    return select_n(in_out, in_out.size() / 2, counters);
   } else if constexpr (std::is_same_v<TParity, EvenNumber>) {
-    const auto& high = sort_n(in_out, in_out.size() / 2 + 1);
-    const auto& low = *(&high - 1);
+    const Index n = in_out.size() / 2;
+    const auto high = select_n(in_out, n, counters);
+    auto low = in_out[0];
+    for (Index i = 1; i < n; ++i) { // Lower half is not necessarily sorted
+      low = in_out[i] < low ? low : in_out[i];
+    }
     return std::midpoint(low, high);
   } else {
     if (size % 2 == 0) {
-      return median<EvenNumber>(in_out);
+      return median<EvenNumber>(in_out, counters);
     } else {
-      return median<OddNumber>(in_out);
+      return median<OddNumber>(in_out, counters);
     }
   }
 }
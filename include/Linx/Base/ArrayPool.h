@@ -5,9 +5,12 @@
 #ifndef _LINXBASE_ARRAYPOOL_H
 #define _LINXBASE_ARRAYPOOL_H
 
+#include "Linx/Base/Instrumentation.h"
+
 #include <Kokkos_Random.hpp> // Random_UniqueIndex::get_state_idx
 #include <cstddef> // size_t
-#include <type_traits> // remove_cvref
+#include <cstdint>
+#include <type_traits> // is_same_v, remove_cvref
 
 namespace Linx {
 
@@ -21,6 +24,7 @@ class ArrayPool {
 private:
 
   using device_type = typename TSpace::device_type; ///< The device type
+  using execution_space = typename device_type::execution_space; ///< The execution space
 
 public:
 
@@ -38,8 +42,14 @@ public:
     /**
      * @brief Constructor (acquires memory).
      */
-    KOKKOS_INLINE_FUNCTION Array(const ArrayPool& pool) :
-        m_pool(pool), m_index(m_pool.get_state()), m_data(&m_pool.m_memory(m_index, 0)),
+    KOKKOS_INLINE_FUNCTION Array(const ArrayPool& pool) : Array(pool, NoCounters()) {}
+
+    /**
+     * @brief Constructor (acquires memory and counts the acquisition retries).
+     */
+    template <typename TCounters>
+    KOKKOS_INLINE_FUNCTION Array(const ArrayPool& pool, const TCounters& counters) :
+        m_pool(pool), m_index(m_pool.get_state(counters)), m_data(&m_pool.m_memory(m_index, 0)),
         m_size(m_pool.m_memory.extent(1))
     {}
 
@@ -87,7 +97,8 @@ public:
    * @brief Constructor.
    * @param size The size of each array
    */
-  ArrayPool(std::size_t size) : m_locks("locks", TSpace().concurrency(), 1), m_memory("memory", m_locks.size(), size) {}
+  ArrayPool(std::size_t size) : m_locks("locks", TSpace().concurrency(), 1), m_memory("memory", m_locks.size(), size)
+  {}
 
   /**
    * @brief Get one of the arrays. 
@@ -97,6 +108,15 @@ public:
     return Array(*this);
   }
 
+  /**
+   * @brief Get one of the arrays and count the acquisition retries as `Counter::PoolRetries`.
+   */
+  template <typename TCounters>
+  KOKKOS_INLINE_FUNCTION Array array(const TCounters& counters) const
+  {
+    return Array(*this, counters);
+  }
+
 private:
 
   /**
@@ -107,6 +127,48 @@ private:
     return Kokkos::Impl::Random_UniqueIndex<device_type>::get_state_idx(m_locks);
   }
 
+  /**
+   * @brief Acquire an array, count the failed attempts, and get its index.
+   * 
+   * `Random_UniqueIndex` does not expose its number of attempts,
+   * so that instrumented acquisitions replay its probing sequence in the space of the pool:
+   * host threads start from their hardware thread index, and CUDA or HIP threads from their global index,
+   * and retry with a stride of one block.
+   * Other device backends probe linearly from the first lock.
+   * Without `LINX_INSTRUMENTATION`, this is `get_state()`.
+   */
+  template <typename TCounters>
+  KOKKOS_INLINE_FUNCTION Index get_state(const TCounters& counters) const
+  {
+    if constexpr (not instrumented || std::is_same_v<TCounters, NoCounters>) {
+      return get_state();
+    } else {
+      const Index size = m_locks.extent(0);
+      Index first = 0;
+      Index stride = 1;
+      Index i = 0;
+      if constexpr (std::is_same_v<typename execution_space::memory_space, Kokkos::HostSpace>) {
+        KOKKOS_IF_ON_HOST((i = execution_space::impl_hardware_thread_id() % size;))
+      }
+#if defined(KOKKOS_ENABLE_CUDA) || defined(KOKKOS_ENABLE_HIP)
+      KOKKOS_IF_ON_DEVICE((
+          first = (threadIdx.x * blockDim.y + threadIdx.y) * blockDim.z + threadIdx.z;
+          stride = blockDim.x * blockDim.y * blockDim.z;
+          i = (((blockIdx.x * gridDim.y + blockIdx.y) * gridDim.z + blockIdx.z) * stride + first) % size;))
+#endif
+      std::uint64_t retries = 0;
+      while (Kokkos::atomic_compare_exchange(&m_locks(i, 0), 0, 1) != 0) {
+        ++retries;
+        i += stride;
+        if (i >= size) {
+          i = first;
+        }
+      }
+      counters.add(Counter::PoolRetries, retries);
+      return i;
+    }
+  }
+
   /**
    * @brief Release an array.
    */
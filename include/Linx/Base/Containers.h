@@ -5,6 +5,7 @@
 #ifndef _LINXBASE_CONTAINERS_H
 #define _LINXBASE_CONTAINERS_H
 
+#include "Linx/Base/Exceptions.h"
 #include "Linx/Base/Types.h"
 
 #include <Kokkos_Core.hpp>
@@ -124,6 +125,89 @@ KOKKOS_INLINE_FUNCTION decltype(auto) as_atomic(const Kokkos::DynRankView<T, TAr
   return Out(in);
 }
 
+/**
+ * @brief Test whether a type is a `DynRankView`.
+ */
+template <typename T>
+struct IsDynRankView : std::false_type {};
+
+/**
+ * @brief `DynRankView` specialization.
+ */
+template <typename T, typename... TArgs>
+struct IsDynRankView<Kokkos::DynRankView<T, TArgs...>> : std::true_type {};
+
+/**
+ * @brief Test whether a data class is backed by a `DynRankView`.
+ */
+template <typename T>
+constexpr bool has_dynamic_rank_view()
+{
+  if constexpr (requires { typename T::Container; }) {
+    return IsDynRankView<typename T::Container>::value;
+  } else {
+    return false;
+  }
+}
+
+/**
+ * @brief Reinterpret a `DynRankView` as an unmanaged `View` of given static rank.
+ * 
+ * The output views the same data with the same layout and memory traits,
+ * such that indexing does not go through the rank-7 padding of `DynRankView`.
+ * It does not hold a reference to the data: the input must outlive it.
+ */
+template <int M, typename T, typename... TArgs>
+auto as_static_rank(const Kokkos::DynRankView<T, TArgs...>& in)
+{
+  using In = Kokkos::DynRankView<T, TArgs...>;
+  using Layout = typename In::array_layout;
+  using Traits = Kokkos::MemoryTraits<In::memory_traits::impl_value | Kokkos::Unmanaged>;
+  using Out = Kokkos::View<typename DefaultContainer<T, M>::Image::data_type, Layout, typename In::device_type, Traits>;
+  Layout layout;
+  for (int i = 0; i < M; ++i) {
+    layout.dimension[i] = in.extent(i);
+    if constexpr (std::is_same_v<Layout, Kokkos::LayoutStride>) {
+      layout.stride[i] = in.stride(i);
+    }
+  }
+  return Out(in.data(), layout);
+}
+
+/**
+ * @brief Call a function with static-rank versions of dynamic-rank data.
+ * 
+ * @param rank The common rank of the inputs
+ * @param func The function
+ * @param ins The inputs, for which `as_static_rank<M>()` is defined
+ * 
+ * The rank is dispatched once, such that `func` is called with statically-ranked inputs.
+ * This is typically used to avoid the per-element overhead of `DynRankView` indexing in kernels.
+ */
+template <typename TFunc, typename... TIns>
+void dispatch_static_rank(int rank, TFunc&& func, const TIns&... ins)
+{
+#define LINX_CASE_RANK(n) \
+  case n: \
+    func(as_static_rank<n>(ins)...); \
+    return;
+
+  switch (rank) {
+    case 0:
+      return;
+      LINX_CASE_RANK(1)
+      LINX_CASE_RANK(2)
+      LINX_CASE_RANK(3)
+      LINX_CASE_RANK(4)
+      LINX_CASE_RANK(5)
+      LINX_CASE_RANK(6)
+    default:
+      throw Linx::OutOfBounds<'[', ']'>("Dynamic rank", rank, {0, 6});
+  }
+
+#undef LINX_CASE_RANK
+}
+
 } // namespace Linx
 
 #endif
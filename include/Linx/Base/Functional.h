@@ -96,10 +96,12 @@ LINX_DEFINE_BINARY_OPERATOR(Divide, (lhs / rhs))
 LINX_DEFINE_BINARY_OPERATOR(Modulus, (lhs % rhs))
 LINX_DEFINE_BINARY_OPERATOR(Equal, (lhs == rhs))
 LINX_DEFINE_BINARY_OPERATOR(NotEqual, (lhs != rhs))
+LINX_DEFINE_BINARY_OPERATOR(Less, (lhs < rhs))
+LINX_DEFINE_BINARY_OPERATOR(Greater, (lhs > rhs))
 LINX_DEFINE_MONOID(And, (lhs && rhs), true)
 LINX_DEFINE_MONOID(Or, (lhs || rhs), false)
-LINX_DEFINE_MONOID(Min, std::min(lhs, rhs), std::numeric_limits<T>::max())
-LINX_DEFINE_MONOID(Max, std::max(lhs, rhs), std::numeric_limits<T>::lowest())
+LINX_DEFINE_MONOID(Min, std::min(lhs, rhs), Limits<T>::max())
+LINX_DEFINE_MONOID(Max, std::max(lhs, rhs), Limits<T>::min())
 
 #undef LINX_DEFINE_BINARY_OPERATOR
 #undef LINX_DEFINE_MONOID
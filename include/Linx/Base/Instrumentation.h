@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_INSTRUMENTATION_H
+#define _LINXBASE_INSTRUMENTATION_H
+
+#include <Kokkos_Core.hpp>
+#include <algorithm> // max, min
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace Linx {
+
+/**
+ * @brief Whether hot-path instrumentation is compiled in.
+ *
+ * Instrumentation is enabled by defining `LINX_INSTRUMENTATION` before including Linx headers,
+ * e.g. with the `-DLINX_INSTRUMENTATION` compiler option.
+ * Otherwise, counters are no-ops which are optimized out.
+ */
+#ifdef LINX_INSTRUMENTATION
+constexpr bool instrumented = true;
+#else
+constexpr bool instrumented = false;
+#endif
+
+/**
+ * @brief The hot-path counters.
+ */
+enum class Counter {
+  Taps = 0, ///< The number of neighbor values read
+  PoolRetries, ///< The number of failed `ArrayPool` acquisition attempts
+  SortShifts, ///< The number of `sort_n()` comparisons which shifted an element
+  SortStops, ///< The number of `sort_n()` insertions which stopped the inner loop
+  Elements ///< The number of output elements
+};
+
+/**
+ * @brief No-op counters, used when instrumentation is disabled.
+ */
+struct NoCounters {
+  /**
+   * @brief Increment a counter.
+   */
+  KOKKOS_INLINE_FUNCTION void add(Counter, std::uint64_t) const {}
+
+  /**
+   * @brief Count one output element for the calling thread.
+   */
+  KOKKOS_INLINE_FUNCTION void count_element() const {}
+};
+
+/**
+ * @brief Device-accessible counters of a kernel.
+ *
+ * The counters are atomically incremented in a view which is owned by the `CounterRegistry`.
+ * Elements are also counted per thread, thanks to a `UniqueToken`.
+ */
+class KernelCounters {
+public:
+
+  using execution_space = Kokkos::DefaultExecutionSpace; ///< The execution space
+  using View = Kokkos::View<std::uint64_t*, execution_space::memory_space>; ///< The counter storage
+  static constexpr int ThreadOffset = static_cast<int>(Counter::Elements) + 1; ///< The first per-thread counter
+
+  /**
+   * @brief Constructor.
+   */
+  KernelCounters(const View& values = View()) : m_values(values), m_token() {}
+
+  /**
+   * @brief Increment a counter.
+   */
+  KOKKOS_INLINE_FUNCTION void add(Counter counter, std::uint64_t n) const
+  {
+    if (n) {
+      Kokkos::atomic_add(&m_values(static_cast<int>(counter)), n);
+    }
+  }
+
+  /**
+   * @brief Count one output element for the calling thread.
+   */
+  KOKKOS_INLINE_FUNCTION void count_element() const
+  {
+    const auto id = m_token.acquire();
+    Kokkos::atomic_inc(&m_values(ThreadOffset + id));
+    m_token.release(id);
+    add(Counter::Elements, 1);
+  }
+
+private:
+
+  View m_values; ///< The counters
+  Kokkos::Experimental::UniqueToken<execution_space> m_token; ///< The thread identifier
+};
+
+/**
+ * @brief The counters type, depending on `LINX_INSTRUMENTATION`.
+ */
+using Counters = std::conditional_t<instrumented, KernelCounters, NoCounters>;
+
+/**
+ * @brief Host-side counter values of a kernel.
+ */
+struct CounterValues {
+  std::uint64_t taps = 0; ///< The number of neighbor values read
+  std::uint64_t pool_retries = 0; ///< The number of failed `ArrayPool` acquisition attempts
+  std::uint64_t sort_shifts = 0; ///< The number of `sort_n()` comparisons which shifted an element
+  std::uint64_t sort_stops = 0; ///< The number of `sort_n()` insertions which stopped the inner loop
+  std::uint64_t elements = 0; ///< The number of output elements
+  std::uint64_t threads = 0; ///< The number of threads which processed elements
+  std::uint64_t min_per_thread = 0; ///< The minimum number of elements processed by a thread
+  std::uint64_t max_per_thread = 0; ///< The maximum number of elements processed by a thread
+};
+
+/**
+ * @brief Snapshot of the counters, as returned by `counter_report()`.
+ */
+struct CounterReport {
+  std::map<std::string, CounterValues> kernels; ///< The values per kernel label
+
+  /**
+   * @brief Stream insertion.
+   */
+  friend std::ostream& operator<<(std::ostream& out, const CounterReport& report)
+  {
+    out << "Counters:\n\n";
+    out << std::left << std::setw(24) << "  Kernel" << std::right << std::setw(14) << "Elements" << std::setw(16)
+        << "Taps" << std::setw(14) << "Pool retries" << std::setw(16) << "Sort shifts" << std::setw(14)
+        << "Sort stops" << std::setw(10) << "Threads" << std::setw(14) << "Min/thread" << std::setw(14)
+        << "Max/thread"
+        << "\n";
+    for (const auto& [label, v] : report.kernels) {
+      out << "  " << std::left << std::setw(22) << label << std::right << std::setw(14) << v.elements << std::setw(16)
+          << v.taps << std::setw(14) << v.pool_retries << std::setw(16) << v.sort_shifts << std::setw(14)
+          << v.sort_stops << std::setw(10) << v.threads << std::setw(14) << v.min_per_thread << std::setw(14)
+          << v.max_per_thread << "\n";
+    }
+    return out;
+  }
+};
+
+/**
+ * @brief Registry of the kernel counters.
+ *
+ * Counters are identified by a kernel label, and shared by all the kernels with this label.
+ * They are released at `Kokkos::finalize()`.
+ */
+class CounterRegistry {
+public:
+
+  /**
+   * @brief Get the registry.
+   */
+  static CounterRegistry& instance()
+  {
+    static CounterRegistry registry;
+    return registry;
+  }
+
+  /**
+   * @brief Get the counters of a kernel, which are created if needed.
+   */
+  KernelCounters::View values(const std::string& label)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_values.empty()) {
+      Kokkos::push_finalize_hook([]() {
+        instance().clear();
+      });
+    }
+    auto it = m_values.find(label);
+    if (it == m_values.end()) {
+      const auto threads = Kokkos::Experimental::UniqueToken<KernelCounters::execution_space>().size();
+      it = m_values.emplace(label, KernelCounters::View("counters", KernelCounters::ThreadOffset + threads)).first;
+    }
+    return it->second;
+  }
+
+  /**
+   * @brief Forget all the counters.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_values.clear();
+  }
+
+  /**
+   * @brief Get a snapshot of the counters.
+   */
+  CounterReport report() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Kokkos::fence();
+    CounterReport out;
+    for (const auto& [label, values] : m_values) {
+      auto on_host = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), values);
+      auto& v = out.kernels[label];
+      v.taps = on_host(static_cast<int>(Counter::Taps));
+      v.pool_retries = on_host(static_cast<int>(Counter::PoolRetries));
+      v.sort_shifts = on_host(static_cast<int>(Counter::SortShifts));
+      v.sort_stops = on_host(static_cast<int>(Counter::SortStops));
+      v.elements = on_host(static_cast<int>(Counter::Elements));
+      for (std::size_t i = KernelCounters::ThreadOffset; i < on_host.size(); ++i) {
+        const auto n = on_host(i);
+        if (n) {
+          v.min_per_thread = v.threads ? std::min(v.min_per_thread, n) : n;
+          v.max_per_thread = std::max(v.max_per_thread, n);
+          ++v.threads;
+        }
+      }
+    }
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Constructor.
+   */
+  CounterRegistry() = default;
+
+  mutable std::mutex m_mutex; ///< The lock
+  std::map<std::string, KernelCounters::View> m_values; ///< The counters per label
+};
+
+/**
+ * @brief Get the counters of a kernel.
+ *
+ * If instrumentation is disabled, this is a no-op which returns `NoCounters`.
+ */
+inline Counters make_counters(const std::string& label)
+{
+#ifdef LINX_INSTRUMENTATION
+  return KernelCounters(CounterRegistry::instance().values(label));
+#else
+  (void)label;
+  return NoCounters();
+#endif
+}
+
+/**
+ * @brief Get a snapshot of the counters.
+ *
+ * The report is empty unless instrumentation is enabled.
+ */
+inline CounterReport counter_report()
+{
+  return CounterRegistry::instance().report();
+}
+
+} // namespace Linx
+
+#endif
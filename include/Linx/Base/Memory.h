@@ -0,0 +1,314 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXBASE_MEMORY_H
+#define _LINXBASE_MEMORY_H
+
+#include "Linx/Base/Exceptions.h"
+
+#include <Kokkos_Core.hpp>
+#include <algorithm> // max, min
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace Linx {
+
+/**
+ * @brief Memory usage of some label or memory space.
+ */
+struct MemoryUsage {
+  std::uint64_t live = 0; ///< The currently allocated size in bytes
+  std::uint64_t peak = 0; ///< The high-water mark of `live`
+  std::uint64_t allocated = 0; ///< The cumulated allocated size in bytes
+  std::size_t allocation_count = 0; ///< The number of allocations
+  std::size_t deallocation_count = 0; ///< The number of deallocations
+
+  /**
+   * @brief Record an allocation.
+   */
+  void allocate(std::uint64_t size)
+  {
+    live += size;
+    peak = std::max(peak, live);
+    allocated += size;
+    ++allocation_count;
+  }
+
+  /**
+   * @brief Record a deallocation.
+   */
+  void deallocate(std::uint64_t size)
+  {
+    live -= std::min(live, size);
+    ++deallocation_count;
+  }
+};
+
+/**
+ * @brief Snapshot of the memory usage, as returned by `memory_report()`.
+ */
+struct MemoryReport {
+  MemoryUsage total; ///< The usage over all memory spaces
+  std::map<std::string, MemoryUsage> spaces; ///< The usage per memory space
+  std::map<std::string, std::map<std::string, MemoryUsage>> labels; ///< The usage per memory space and label
+  std::uint64_t budget = 0; ///< The soft budget, or 0 if unlimited
+
+  /**
+   * @brief Stream insertion.
+   */
+  friend std::ostream& operator<<(std::ostream& out, const MemoryReport& report)
+  {
+    out << "Memory: " << report.total.live << " B live, " << report.total.peak << " B peak, "
+        << report.total.allocation_count << " allocations";
+    if (report.budget) {
+      out << ", " << report.budget << " B budget";
+    }
+    out << "\n\n";
+    out << std::left << std::setw(40) << "  Label" << std::right << std::setw(12) << "Space" << std::setw(16)
+        << "Live (B)" << std::setw(16) << "Peak (B)" << std::setw(10) << "Allocs" << std::setw(10) << "Deallocs"
+        << std::setw(16) << "Total (B)"
+        << "\n";
+    for (const auto& [space, labels] : report.labels) {
+      for (const auto& [label, u] : labels) {
+        out << "  " << std::left << std::setw(38) << label << std::right << std::setw(12) << space << std::setw(16)
+            << u.live << std::setw(16) << u.peak << std::setw(10) << u.allocation_count << std::setw(10)
+            << u.deallocation_count << std::setw(16) << u.allocated << "\n";
+      }
+    }
+    return out;
+  }
+};
+
+/**
+ * @ingroup exceptions
+ * @brief Exception thrown when an allocation would exceed the soft memory budget.
+ */
+class MemoryBudgetExceeded : public Exception {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  MemoryBudgetExceeded(const std::string& label, std::uint64_t size, std::uint64_t live, std::uint64_t budget) :
+      Exception(
+          "Memory budget exceeded",
+          "Cannot allocate " + std::to_string(size) + " B for " + label + " (" + std::to_string(live) + " B live, " +
+              std::to_string(budget) + " B budget)")
+  {}
+
+  /**
+   * @brief Throw if an allocation would exceed the budget.
+   */
+  static void may_throw(const std::string& label, std::uint64_t size, std::uint64_t live, std::uint64_t budget)
+  {
+    if (budget && live + size > budget) {
+      throw MemoryBudgetExceeded(label, size, live, budget);
+    }
+  }
+};
+
+/**
+ * @brief Memory accounting layer.
+ *
+ * Once started, the tracker records the live bytes, peak usage and allocation counts per memory space and label,
+ * thanks to Kokkos Tools callbacks.
+ * Since data classes propagate their label to Kokkos, this allows tracking each `Image` or `Sequence`,
+ * as well as hidden temporaries, e.g. `copy(a)` for `+a`.
+ *
+ * Optionally, a soft budget can be set with `set_budget()`.
+ * Data classes check it before allocating, and `MemoryBudgetExceeded` is thrown
+ * if the total live size would exceed it.
+ *
+ * \code
+ * Linx::MemoryTracker::instance().set_budget(8UL << 30); // 8 GiB
+ * ...
+ * std::cout << Linx::memory_report() << std::endl;
+ * \endcode
+ *
+ * Kokkos must be initialized before the tracker is started.
+ *
+ * @see `memory_report()`
+ */
+class MemoryTracker {
+public:
+
+  /**
+   * @brief Get the tracker.
+   */
+  static MemoryTracker& instance()
+  {
+    static MemoryTracker tracker;
+    return tracker;
+  }
+
+  /**
+   * @brief Register the callbacks and start recording.
+   */
+  void start()
+  {
+    Kokkos::Tools::Experimental::set_allocate_data_callback(allocate_data);
+    Kokkos::Tools::Experimental::set_deallocate_data_callback(deallocate_data);
+    m_enabled = true;
+  }
+
+  /**
+   * @brief Unregister the callbacks and stop recording.
+   *
+   * The budget is disabled, too.
+   */
+  void stop()
+  {
+    m_enabled = false;
+    m_budget = 0;
+    Kokkos::Tools::Experimental::set_allocate_data_callback(nullptr);
+    Kokkos::Tools::Experimental::set_deallocate_data_callback(nullptr);
+  }
+
+  /**
+   * @brief Check whether the tracker is recording.
+   */
+  bool enabled() const
+  {
+    return m_enabled;
+  }
+
+  /**
+   * @brief Forget all the recorded data.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_report = MemoryReport();
+  }
+
+  /**
+   * @brief Set the soft budget in bytes, or 0 to disable it.
+   *
+   * The tracker is started if needed.
+   */
+  void set_budget(std::uint64_t bytes)
+  {
+    if (bytes && not m_enabled) {
+      start();
+    }
+    m_budget = bytes;
+  }
+
+  /**
+   * @brief Get the soft budget, or 0 if disabled.
+   */
+  std::uint64_t budget() const
+  {
+    return m_budget;
+  }
+
+  /**
+   * @brief Throw if allocating some size would exceed the budget.
+   */
+  void reserve(const std::string& label, std::uint64_t size) const
+  {
+    const auto budget = m_budget.load();
+    if (not budget) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MemoryBudgetExceeded::may_throw(label, size, m_report.total.live, budget);
+  }
+
+  /**
+   * @brief Get a snapshot of the recorded data.
+   */
+  MemoryReport report() const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto out = m_report;
+    out.budget = m_budget;
+    return out;
+  }
+
+private:
+
+  /**
+   * @brief Constructor.
+   */
+  MemoryTracker() = default;
+
+  /**
+   * @brief Record an allocation or deallocation.
+   */
+  void record(const char* space, const char* label, std::uint64_t size, bool allocation)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& by_space = m_report.spaces[space];
+    auto& by_label = m_report.labels[space][label];
+    if (allocation) {
+      m_report.total.allocate(size);
+      by_space.allocate(size);
+      by_label.allocate(size);
+    } else {
+      m_report.total.deallocate(size);
+      by_space.deallocate(size);
+      by_label.deallocate(size);
+    }
+  }
+
+  /// @cond
+  static void allocate_data(Kokkos::Tools::SpaceHandle space, const char* label, const void*, std::uint64_t size)
+  {
+    instance().record(space.name, label, size, true);
+  }
+
+  static void deallocate_data(Kokkos::Tools::SpaceHandle space, const char* label, const void*, std::uint64_t size)
+  {
+    instance().record(space.name, label, size, false);
+  }
+  /// @endcond
+
+private:
+
+  mutable std::mutex m_mutex; ///< The lock for concurrent callbacks
+  bool m_enabled = false; ///< The recording status
+  std::atomic<std::uint64_t> m_budget = 0; ///< The soft budget
+  MemoryReport m_report; ///< The recorded data
+};
+
+/**
+ * @brief Get a snapshot of the memory usage.
+ *
+ * The report is empty unless the `MemoryTracker` was started.
+ */
+inline MemoryReport memory_report()
+{
+  return MemoryTracker::instance().report();
+}
+
+/**
+ * @brief Check the memory budget before allocating a container of given value type and extents.
+ * @return The label
+ *
+ * Invalid extents (`KOKKOS_INVALID_INDEX`), which are used to pad dynamic-rank shapes, are ignored.
+ * This is a no-op if no budget is set.
+ */
+template <typename T>
+const std::string& budgeted(const std::string& label, std::integral auto... extents)
+{
+  const auto& tracker = MemoryTracker::instance();
+  if (tracker.budget()) {
+    std::uint64_t size = sizeof(T);
+    ((size *= (static_cast<std::size_t>(extents) == KOKKOS_INVALID_INDEX ? 1 : static_cast<std::size_t>(extents))),
+     ...);
+    tracker.reserve(label, size);
+  }
+  return label;
+}
+
+} // namespace Linx
+
+#endif
@@ -34,7 +34,7 @@ public:
 
   KOKKOS_INLINE_FUNCTION value_type operator()(auto... is) const
   {
-    return m_func(get<Is>(m_ins)(is...)...);
+    return static_cast<value_type>(m_func(get<Is>(m_ins)(is...)...));
   }
 
 private:
@@ -115,7 +115,7 @@ public:
   {
     auto tuple = forward_as_tuple(args...);
     static_assert(sizeof...(args) == Rank + 1);
-    m_reducer.join(get<Rank>(tuple), m_projection(get<Is>(tuple)...));
+    m_reducer.join(get<Rank>(tuple), static_cast<value_type>(m_projection(get<Is>(tuple)...)));
   }
 
 private:
@@ -214,13 +214,27 @@ void kokkos_reduce(const std::string& label, const TRegion& region, const TProj&
  * 
  * The monoid is an associative binary operator functor, for which `identity_element()` is defined,
  * i.e. the following is available: `identity_element<T>(monoid)`, where `T` is the element type of `in`.
+ *
+ * The accumulator type is `ComputeType<T>`, which is also the return type,
+ * i.e. 16-bit floating point values are converted to `float` at load and accumulated as `float`,
+ * which avoids both the overflow and the loss of precision of 16-bit partial sums.
  */
 template <typename TMonoid, typename TIn>
 auto reduce(const std::string& label, const TMonoid& monoid, const TIn& in)
 {
-  using T = typename TIn::element_type;
+  using T = ComputeType<typename TIn::element_type>;
   using Reducer = Impl::Reducer<T, TMonoid, Kokkos::HostSpace>;
   T value = identity_element<T>(monoid);
+  if constexpr (has_dynamic_rank_view<TIn>()) {
+    // Fast path: dispatch the rank once instead of indexing a DynRankView in the kernel
+    dispatch_static_rank(
+        in.rank(),
+        [&](const auto& ranked) {
+          value = reduce(label, monoid, ranked);
+        },
+        in);
+    return value;
+  }
   kokkos_reduce<typename TIn::execution_space>(
       label,
       in.domain(),
@@ -247,6 +261,9 @@ auto reduce(const std::string& label, const TMonoid& monoid, const TIn& in)
  * 
  * where `p0, p1, ... , pN` are the positions in the image domain and `+` denotes the monoid operator.
  * 
+ * As for `reduce()`, the mapped values are accumulated as `ComputeType<T>`,
+ * where `T` is the element type of the first input, unless the monoid identity element is of another type.
+ * 
  * Typically, the dot product of two containers `a` and `b` can be implemented as:
  * 
  * \code
@@ -275,12 +292,30 @@ auto map_reduce_with_side_effects_impl(
     std::index_sequence<Is...>)
 {
   const auto& in0 = get<0>(ins);
-  using Value = std::decay_t<decltype(in0)>::element_type;
+  using Value = ComputeType<typename std::decay_t<decltype(in0)>::element_type>;
   using T = decltype(identity_element<Value>(monoid));
   using Space = std::decay_t<decltype(in0)>::execution_space; // FIXME test accessibility of all Is
   using Projection = Impl::Projection<T, TMap, TIns, Is...>;
   using Reducer = Impl::Reducer<T, TMonoid, Kokkos::HostSpace>;
   T value = identity_element<T>(monoid);
+  if constexpr ((has_dynamic_rank_view<std::decay_t<decltype(get<Is>(ins))>>() && ...)) {
+    // Fast path: dispatch the rank once instead of indexing DynRankViews in the kernel
+    const auto rank = in0.rank();
+    if (((get<Is>(ins).rank() == rank) && ...)) {
+      dispatch_static_rank(
+          rank,
+          [&](const auto&... ranked) {
+            value = map_reduce_with_side_effects_impl(
+                label,
+                map,
+                monoid,
+                Tuple<std::decay_t<decltype(ranked)>...>(ranked...),
+                std::index_sequence<Is...>());
+          },
+          get<Is>(ins)...);
+      return value;
+    }
+  }
   kokkos_reduce<Space>(label, in0.domain(), Projection(map, ins), Reducer(value, monoid, identity_element<T>(monoid)));
   Kokkos::fence();
   return value;
@@ -318,16 +353,162 @@ typename TIn::element_type max(const TIn& in)
  * @brief Compute the sum of all elements of a data container.
  */
 template <typename TIn>
-typename TIn::element_type sum(const TIn& in) // FIXME limit to DataMixins
+ComputeType<typename TIn::element_type> sum(const TIn& in) // FIXME limit to DataMixins
 {
   return reduce("sum", Add(), in);
 }
 
+namespace Impl {
+
+/**
+ * @brief Map which replaces invalid values, and values with nonzero mask values if any, with 0.
+ */
+template <typename T>
+struct ValidOrZero {
+  /**
+   * @brief Map a value.
+   */
+  KOKKOS_INLINE_FUNCTION T operator()(const auto& value) const
+  {
+    return is_valid(value) ? static_cast<T>(value) : T {};
+  }
+
+  /**
+   * @brief Map a value with its mask.
+   */
+  KOKKOS_INLINE_FUNCTION T operator()(const auto& value, const auto& mask) const
+  {
+    return (is_valid(value) && not mask) ? static_cast<T>(value) : T {};
+  }
+};
+
+/**
+ * @brief Sum and count of valid values.
+ */
+template <typename T>
+struct ValidSum {
+  T m_sum; ///< The sum
+  Index m_count; ///< The count
+
+  /**
+   * @brief Merge two partial sums.
+   */
+  KOKKOS_INLINE_FUNCTION ValidSum operator+(const ValidSum& rhs) const
+  {
+    return {m_sum + rhs.m_sum, m_count + rhs.m_count};
+  }
+};
+
+/**
+ * @brief Map which turns valid values into a `ValidSum` of count 1, and invalid values into the null `ValidSum`.
+ */
+template <typename T>
+struct ToValidSum {
+  /**
+   * @brief Map a value.
+   */
+  KOKKOS_INLINE_FUNCTION ValidSum<T> operator()(const auto& value) const
+  {
+    return is_valid(value) ? ValidSum<T> {static_cast<T>(value), 1} : ValidSum<T> {};
+  }
+
+  /**
+   * @brief Map a value with its mask.
+   */
+  KOKKOS_INLINE_FUNCTION ValidSum<T> operator()(const auto& value, const auto& mask) const
+  {
+    return (is_valid(value) && not mask) ? ValidSum<T> {static_cast<T>(value), 1} : ValidSum<T> {};
+  }
+};
+
+/**
+ * @brief Compute the mean of the valid values in a single reduction.
+ */
+template <typename T, typename TIns, std::size_t... Is>
+T nanmean_impl(const std::string& label, const TIns& ins, std::index_sequence<Is...>)
+{
+  using Value = ValidSum<T>;
+  using Projection = Impl::Projection<Value, ToValidSum<T>, TIns, Is...>;
+  using Reducer = Impl::Reducer<Value, Add<Forward, Forward>, Kokkos::HostSpace>;
+  const auto& in0 = get<0>(ins);
+  using Space = typename std::decay_t<decltype(in0)>::execution_space;
+  Value value {};
+  kokkos_reduce<Space>(label, in0.domain(), Projection(ToValidSum<T>(), ins), Reducer(value, Add(), Value {}));
+  Kokkos::fence();
+  return value.m_count ? value.m_sum / value.m_count : invalid_value<T>();
+}
+
+/**
+ * @brief The floating point type of a mean.
+ */
+template <typename T>
+using MeanType = std::conditional_t<std::is_integral_v<ComputeType<T>>, double, ComputeType<T>>;
+
+} // namespace Impl
+
+/**
+ * @brief Compute the sum of the valid elements of a data container, i.e. skipping NaNs and infinities.
+ *
+ * The validity test is fused with the reduction.
+ */
+template <typename TIn>
+ComputeType<typename TIn::element_type> nansum(const TIn& in)
+{
+  using T = ComputeType<std::remove_cv_t<typename TIn::element_type>>;
+  return map_reduce("nansum", Impl::ValidOrZero<T>(), Add(), in);
+}
+
+/**
+ * @brief Compute the sum of the valid and unmasked elements of a data container.
+ *
+ * @param in The input container
+ * @param mask The mask, where nonzero values denote invalid elements
+ */
+template <typename TIn, typename TMask>
+ComputeType<typename TIn::element_type> nansum(const TIn& in, const TMask& mask)
+{
+  SizeMismatch::may_throw("mask", mask.size(), in);
+  using T = ComputeType<std::remove_cv_t<typename TIn::element_type>>;
+  return map_reduce("nansum", Impl::ValidOrZero<T>(), Add(), in, mask);
+}
+
+/**
+ * @brief Compute the mean of the valid elements of a data container, i.e. skipping NaNs and infinities.
+ *
+ * The sum and count of valid elements are computed in a single reduction.
+ * The mean of integral values is a `double`.
+ * If there is no valid element, the result is NaN.
+ */
+template <typename TIn>
+Impl::MeanType<std::remove_cv_t<typename TIn::element_type>> nanmean(const TIn& in)
+{
+  using T = Impl::MeanType<std::remove_cv_t<typename TIn::element_type>>;
+  using Ins = Tuple<std::decay_t<decltype(as_readonly(in))>>;
+  return Impl::nanmean_impl<T>("nanmean", Ins(as_readonly(in)), std::make_index_sequence<1>());
+}
+
+/**
+ * @brief Compute the mean of the valid and unmasked elements of a data container.
+ *
+ * @param in The input container
+ * @param mask The mask, where nonzero values denote invalid elements
+ *
+ * @copydetails nanmean()
+ */
+template <typename TIn, typename TMask>
+Impl::MeanType<std::remove_cv_t<typename TIn::element_type>> nanmean(const TIn& in, const TMask& mask)
+{
+  SizeMismatch::may_throw("mask", mask.size(), in);
+  using T = Impl::MeanType<std::remove_cv_t<typename TIn::element_type>>;
+  using Ins = Tuple<std::decay_t<decltype(as_readonly(in))>, std::decay_t<decltype(as_readonly(mask))>>;
+  return Impl::nanmean_impl<T>("nanmean", Ins(as_readonly(in), as_readonly(mask)), std::make_index_sequence<2>());
+}
+
 /**
  * @brief Compute the product of all elements of a data container.
  */
 template <typename TIn>
-typename TIn::element_type product(const TIn& in) // FIXME limit to DataMixins
+ComputeType<typename TIn::element_type> product(const TIn& in) // FIXME limit to DataMixins
 {
   return reduce("product", Multiply(), in);
 }
@@ -336,7 +517,7 @@ typename TIn::element_type product(const TIn& in) // FIXME limit to DataMixins
  * @brief Compute the dot product of two data containers.
  */
 template <typename TLhs, typename TRhs>
-typename TLhs::element_type dot(const TLhs& lhs, const TRhs& rhs)
+ComputeType<typename TLhs::element_type> dot(const TLhs& lhs, const TRhs& rhs)
 {
   return map_reduce("dot", Multiply(), Add(), lhs, rhs);
 }
@@ -346,7 +527,7 @@ typename TLhs::element_type dot(const TLhs& lhs, const TRhs& rhs)
  * @tparam P The power
  */
 template <int P, typename TIn>
-typename TIn::element_type norm(const TIn& in)
+ComputeType<typename TIn::element_type> norm(const TIn& in)
 {
   return map_reduce("norm", Abspow<P>(), Add(), in);
 }
@@ -356,7 +537,7 @@ typename TIn::element_type norm(const TIn& in)
  * @tparam P The power
  */
 template <int P, typename TLhs, typename TRhs>
-typename TLhs::element_type distance(const TLhs& lhs, const TRhs& rhs)
+ComputeType<typename TLhs::element_type> distance(const TLhs& lhs, const TRhs& rhs)
 {
   return map_reduce("distance", Abspow<P>(), Add(), lhs, rhs);
 }
@@ -387,9 +387,9 @@ auto kokkos_execution_policy(const Slice<T, SliceType::RightOpen>& region)
  * @tparam TSpace The execution space
  */
 template <typename TSpace = Kokkos::DefaultExecutionSpace, std::integral T>
-void for_each(const std::string& label, const Slice<T, SliceType::RightOpen>& region, auto&& func)
+void for_each(const auto& label, const Slice<T, SliceType::RightOpen>& region, auto&& func)
 {
-  Kokkos::parallel_for(label, kokkos_execution_policy<TSpace>(region), LINX_FORWARD(func));
+  Kokkos::parallel_for(kernel_label(label), kokkos_execution_policy<TSpace>(region), LINX_FORWARD(func));
 }
 
 /**
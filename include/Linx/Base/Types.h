@@ -6,6 +6,7 @@
 #define _LINXBASE_TYPES_H
 
 #include <Kokkos_Complex.hpp>
+#include <Kokkos_Core.hpp> // Tools::profileLibraryLoaded
 #include <complex>
 #include <concepts>
 #include <limits>
@@ -233,6 +234,63 @@ KOKKOS_INLINE_FUNCTION TInt floor(TFloat in)
   return out - (in < 0);
 }
 
+/**
+ * @brief Test whether a type is a 16-bit floating point type, i.e. `Kokkos::Experimental::half_t` or `bhalf_t`.
+ *
+ * If the backend has no native support for some 16-bit type, Kokkos emulates it with a `float` wrapper,
+ * which is still considered as a 16-bit type here.
+ */
+template <typename T>
+constexpr bool is_half()
+{
+  using U = std::remove_cv_t<T>;
+  return std::is_same_v<U, Kokkos::Experimental::half_t> || std::is_same_v<U, Kokkos::Experimental::bhalf_t>;
+}
+
+/**
+ * @brief The type in which values of type `T` are computed.
+ *
+ * This is `float` for 16-bit floating point types, which are only a storage format:
+ * values are converted to `float` at load and back to `T` at store.
+ * This is `T` itself for other types.
+ */
+template <typename T>
+using ComputeType = std::conditional_t<is_half<T>(), float, T>;
+
+namespace Impl {
+
+/**
+ * @brief Numeric limits of 16-bit floating point types, as `float`.
+ */
+template <typename T>
+struct HalfLimits {
+  static constexpr bool emulated = sizeof(T) == sizeof(float); ///< Whether the type is a `float` wrapper
+  static constexpr bool bfloat = std::is_same_v<T, Kokkos::Experimental::bhalf_t> &&
+      !std::is_same_v<T, Kokkos::Experimental::half_t>; ///< Whether the type is `bhalf_t`
+
+  KOKKOS_INLINE_FUNCTION static constexpr float lowest()
+  {
+    return -max();
+  }
+
+  KOKKOS_INLINE_FUNCTION static constexpr float max()
+  {
+    return emulated ? std::numeric_limits<float>::max() : bfloat ? 3.38953139e38F : 65504.F;
+  }
+
+  KOKKOS_INLINE_FUNCTION static constexpr float infinity()
+  {
+    return std::numeric_limits<float>::infinity();
+  }
+
+  KOKKOS_INLINE_FUNCTION static constexpr float epsilon()
+  {
+    return emulated ? std::numeric_limits<float>::epsilon() : bfloat ? 0.0078125F : 0.0009765625F;
+  }
+};
+
+} // namespace Impl
+
 /**
  * @brief Numeric limits and related key values of a value type.
  */
@@ -243,6 +301,11 @@ struct Limits {
    */
   using Scalar = typename TypeTraits<T>::Scalar;
 
+  /**
+   * @brief The numeric limits of the scalar type.
+   */
+  using Bounds = std::conditional_t<is_half<Scalar>(), Impl::HalfLimits<Scalar>, std::numeric_limits<Scalar>>;
+
   /**
    * @brief 0 in general, or `false` for Booleans.
    */
@@ -264,7 +327,7 @@ struct Limits {
    */
   KOKKOS_INLINE_FUNCTION static T min()
   {
-    return TypeTraits<T>::from_scalar(std::numeric_limits<Scalar>::lowest());
+    return TypeTraits<T>::from_scalar(Bounds::lowest());
   }
 
   /**
@@ -272,7 +335,7 @@ struct Limits {
    */
   KOKKOS_INLINE_FUNCTION static T max()
   {
-    return TypeTraits<T>::from_scalar(std::numeric_limits<Scalar>::max());
+    return TypeTraits<T>::from_scalar(Bounds::max());
   }
 
   /**
@@ -280,7 +343,7 @@ struct Limits {
    */
   KOKKOS_INLINE_FUNCTION static T inf()
   {
-    constexpr auto infinity = std::numeric_limits<Scalar>::infinity();
+    constexpr auto infinity = Bounds::infinity();
     return infinity ? TypeTraits<T>::from_scalar(infinity) : max();
   }
 
@@ -292,7 +355,7 @@ struct Limits {
     if constexpr (std::is_integral_v<T>) {
       return T(1);
     } else {
-      return TypeTraits<T>::from_scalar(std::numeric_limits<Scalar>::epsilon());
+      return TypeTraits<T>::from_scalar(Bounds::epsilon());
     }
   }
 
@@ -349,6 +412,44 @@ constexpr bool is_complex()
   return IsComplex<T>::value;
 }
 
+/**
+ * @brief Test whether a value is valid, i.e. is not a NaN or infinity.
+ *
+ * Values of integral types are always valid.
+ * Complex values are valid if both parts are.
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION bool is_valid(const T& value)
+{
+  using U = ComputeType<std::remove_cv_t<T>>;
+  if constexpr (is_complex<U>()) {
+    return Kokkos::isfinite(value.real()) && Kokkos::isfinite(value.imag());
+  } else if constexpr (std::is_floating_point_v<U>) {
+    return Kokkos::isfinite(static_cast<U>(value));
+  } else {
+    return true;
+  }
+}
+
+/**
+ * @brief The value of undefined results, e.g. the mean of no valid values.
+ *
+ * This is NaN for floating point and complex types, and 0 otherwise.
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION T invalid_value()
+{
+  using U = ComputeType<std::remove_cv_t<T>>;
+  if constexpr (is_complex<U>()) {
+    constexpr auto nan = Kokkos::Experimental::quiet_NaN_v<typename U::value_type>;
+    return T(nan, nan);
+  } else if constexpr (std::is_floating_point_v<U>) {
+    return static_cast<T>(Kokkos::Experimental::quiet_NaN_v<U>);
+  } else {
+    return T {};
+  }
+}
+
 namespace Impl {
 
 template <template <typename...> class C, typename... Ts>
@@ -409,6 +510,96 @@ inline std::string compose_label(const std::string& func)
   return func + "()";
 }
 
+/**
+ * @brief A label which is only formatted when needed.
+ * 
+ * A composed label stores the function name and references to the inputs,
+ * such that building it costs no formatting nor heap allocation.
+ * The string `<func>(<in.label()>)` is materialized by `label()` or by conversion to `std::string`,
+ * e.g. when the label is attached to a new container or to an exception.
+ * Kernels launched with such a label are named after the function only,
+ * unless a Kokkos Tools library or the `Profiler` is active (see `kernel_label()`).
+ * 
+ * As it holds references, a composed label must not outlive its inputs.
+ * @see `lazy_label()`
+ */
+template <typename... Ts>
+class ComposedLabel {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  ComposedLabel(const char* func, const Ts&... ins) : m_func(func), m_ins(ins...) {}
+
+  /**
+   * @brief The function name.
+   */
+  const char* func() const
+  {
+    return m_func;
+  }
+
+  /**
+   * @brief Materialize the label.
+   */
+  std::string label() const
+  {
+    return std::apply(
+        [&](const auto&... ins) {
+          return compose_label(m_func, ins...);
+        },
+        m_ins);
+  }
+
+  /**
+   * @brief Materialize the label.
+   */
+  operator std::string() const
+  {
+    return label();
+  }
+
+private:
+
+  const char* m_func; ///< The function name
+  std::tuple<const Ts&...> m_ins; ///< The inputs
+};
+
+/**
+ * @brief Make a `ComposedLabel`.
+ * 
+ * This is the lazy counterpart of `compose_label()`, for labels which are only used to name kernels.
+ */
+template <typename... Ts>
+ComposedLabel<Ts...> lazy_label(const char* func, const Ts&... ins)
+{
+  return ComposedLabel<Ts...>(func, ins...);
+}
+
+/**
+ * @brief Get the name of a kernel from a label.
+ */
+inline const std::string& kernel_label(const std::string& label)
+{
+  return label;
+}
+
+/**
+ * @copybrief kernel_label()
+ * 
+ * The label is materialized only if profiling callbacks are registered,
+ * otherwise the function name is used.
+ */
+template <typename... Ts>
+std::string kernel_label(const ComposedLabel<Ts...>& label)
+{
+  if (Kokkos::Tools::profileLibraryLoaded()) {
+    return label.label();
+  }
+  return label.func();
+}
+
 template <typename T>
 using DisableIfReference = std::enable_if_t<not std::is_reference_v<T>>;
 
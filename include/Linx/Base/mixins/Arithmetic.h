@@ -17,7 +17,7 @@ namespace Linx {
 #define LINX_SCALAR_OPERATOR_INPLACE(op, Func) \
   const TDerived& operator op##=(const T& rhs) const \
   { \
-    return LINX_CRTP_CONST_DERIVED.apply(compose_label(#op, LINX_CRTP_CONST_DERIVED, rhs), Func(rhs)); \
+    return LINX_CRTP_CONST_DERIVED.apply(lazy_label(#op, LINX_CRTP_CONST_DERIVED, rhs), Func(rhs)); \
   }
 
 #define LINX_SCALAR_OPERATOR_NEWINSTANCE(op) \
@@ -38,7 +38,7 @@ namespace Linx {
   { \
     const auto& derived_rhs = static_cast<const UDerived&>(rhs); \
     return LINX_CRTP_CONST_DERIVED \
-        .apply(compose_label(#op, LINX_CRTP_CONST_DERIVED, derived_rhs), Func(), derived_rhs); \
+        .apply(lazy_label(#op, LINX_CRTP_CONST_DERIVED, derived_rhs), Func(), derived_rhs); \
   }
 
 #define LINX_VECTOR_OPERATOR_NEWINSTANCE(op) \
@@ -142,13 +142,13 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
    */
   const TDerived& copy_from(const auto& container) const
   {
-    return generate(compose_label("copy", container), Forward(), container);
+    return generate(lazy_label("copy", container), Forward(), container);
   }
 
   /**
    * @brief Apply a function to each element.
    * 
-   * @param label A label for debugging
+   * @param label A label for debugging, e.g. a string or a `ComposedLabel`
    * @param func The function
    * @param inputs Optional input containers
    * 
@@ -178,7 +178,7 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
    * 
    * @see `generate()`
    */
-  const TDerived& apply(const std::string& label, auto&& func, const auto&... inputs) const
+  const TDerived& apply(const auto& label, auto&& func, const auto&... inputs) const
   {
     const auto& derived = as_readonly(LINX_CRTP_CONST_DERIVED);
     return LINX_CRTP_CONST_DERIVED
@@ -188,7 +188,7 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
   /**
    * @brief Assign each element according to a function.
    * 
-   * @param label A label for debugging
+   * @param label A label for debugging, e.g. a string or a `ComposedLabel`
    * @param func The function
    * @param inputs Optional input images
    * 
@@ -208,7 +208,7 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
    * 
    * @see `apply()`
    */
-  const TDerived& generate(const std::string& label, auto&& func, const auto&... inputs) const
+  const TDerived& generate(const auto& label, auto&& func, const auto&... inputs) const
   {
     return generate_with_side_effects(label, LINX_FORWARD(func), as_readonly(inputs)...);
   }
@@ -216,7 +216,7 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
   /**
    * @brief Assign each element according to a function.
    * 
-   * @param label A label for debugging
+   * @param label A label for debugging, e.g. a string or a `ComposedLabel`
    * @param func The function
    * @param others Optional containers the function acts on
    * 
@@ -244,7 +244,7 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
    * @see `DataMixin::generate()`
    */
   template <typename TFunc, typename... Ts>
-  const TDerived& generate_with_side_effects(const std::string& label, TFunc&& func, const Ts&... others) const
+  const TDerived& generate_with_side_effects(const auto& label, TFunc&& func, const Ts&... others) const
   {
     generate_with_side_effects_impl(
         label,
@@ -256,17 +256,34 @@ struct DataMixin : public ArithmeticMixin<TArithmetic, T, TDerived>, public Math
 
   template <typename TFunc, typename TIns, std::size_t... Is>
   void generate_with_side_effects_impl(
-      const std::string& label,
+      const auto& label,
       TFunc func,
       const TIns& others,
       std::index_sequence<Is...>) const // FIXME private
   {
+    const auto& derived = LINX_CRTP_CONST_DERIVED;
+    if constexpr (
+        has_dynamic_rank_view<TDerived>() && (has_dynamic_rank_view<std::decay_t<decltype(get<Is>(others))>>() && ...)) {
+      // Fast path: dispatch the rank once instead of indexing DynRankViews in the kernel
+      const auto rank = derived.rank();
+      if (((get<Is>(others).rank() == rank) && ...)) {
+        dispatch_static_rank(
+            rank,
+            [&](const auto& out, const auto&... ins) {
+              out.generate_with_side_effects_impl(
+                  label,
+                  func,
+                  Tuple<std::decay_t<decltype(ins)>...>(ins...),
+                  std::index_sequence<Is...>());
+            },
+            derived,
+            get<Is>(others)...);
+        return;
+      }
+    }
     using Generator = Impl::Generator<TFunc, TDerived, TIns, Is...>;
     using Space = typename TDerived::execution_space;
-    for_each<Space>(
-        label,
-        LINX_CRTP_CONST_DERIVED.domain(),
-        Generator(LINX_FORWARD(func), LINX_CRTP_CONST_DERIVED, others));
+    for_each<Space>(label, derived.domain(), Generator(LINX_FORWARD(func), derived, others));
   }
 
   /// @group_operations
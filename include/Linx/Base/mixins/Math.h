@@ -30,6 +30,7 @@ T pi()
  * 
  * Implements element-wise mathematical functions which may take a range or scalar argument (or none).
  * In the former case, the number of elements in the range must match that of the container.
+ * Values of 16-bit floating point types are computed as `float`, see `ComputeType`.
  * @see pixelwise
  * @see https://en.cppreference.com/w/cpp/header/cmath for functions description
  */
@@ -41,7 +42,7 @@ struct MathFunctionsMixin {
   { \
     return LINX_CRTP_CONST_DERIVED.apply( \
         #function, \
-        KOKKOS_LAMBDA(const T& e) { return std::function(e); }); \
+        KOKKOS_LAMBDA(const T& e) { return T(std::function(static_cast<ComputeType<T>>(e))); }); \
   }
 
 #define LINX_MATH_BINARY_INPLACE(function) \
@@ -50,7 +51,9 @@ struct MathFunctionsMixin {
   { \
     return LINX_CRTP_CONST_DERIVED.apply( \
         #function, \
-        KOKKOS_LAMBDA(const T& e, const T& f) { return std::function(e, f); }, \
+        KOKKOS_LAMBDA(const T& e, const T& f) { \
+          return T(std::function(static_cast<ComputeType<T>>(e), static_cast<ComputeType<T>>(f))); \
+        }, \
         other); \
   }
 
@@ -60,7 +63,9 @@ struct MathFunctionsMixin {
   { \
     return LINX_CRTP_CONST_DERIVED.apply( \
         #function, \
-        KOKKOS_LAMBDA(const T& e) { return std::function(e, other); }); \
+        KOKKOS_LAMBDA(const T& e) { \
+          return T(std::function(static_cast<ComputeType<T>>(e), static_cast<ComputeType<T>>(other))); \
+        }); \
   }
 
   LINX_MATH_UNARY_INPLACE(abs)
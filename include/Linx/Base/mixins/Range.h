@@ -124,7 +124,17 @@ struct RangeMixin<true, T, TDerived> {
   const TDerived& reverse() const // TODO to DataMixin
   {
     const auto& derived = LINX_CRTP_CONST_DERIVED;
-    std::reverse(std::ranges::begin(derived), std::ranges::end(derived));
+    const auto size = derived.size();
+    auto ptr = derived.data();
+    using Space = typename TDerived::execution_space;
+    Kokkos::parallel_for(
+        "reverse()",
+        Kokkos::RangePolicy<Space>(0, size / 2),
+        KOKKOS_LAMBDA(int i) {
+          const auto tmp = ptr[i];
+          ptr[i] = ptr[size - 1 - i];
+          ptr[size - 1 - i] = tmp;
+        });
     return derived;
   }
 
@@ -151,7 +161,7 @@ struct RangeMixin<true, T, TDerived> {
     Kokkos::parallel_for(
         "range()",
         Kokkos::RangePolicy<Space>(0, size),
-        KOKKOS_LAMBDA(int i) { ptr[i] = min + step * i; });
+        KOKKOS_LAMBDA(int i) { ptr[i] = static_cast<ComputeType<T>>(min) + static_cast<ComputeType<T>>(step) * i; });
   }
   /// @endcond
 };
@@ -596,12 +596,15 @@ auto kokkos_execution_policy(const GBox<T, N>& domain)
  * The coordinate type must be integral and the function must take integral coordinates as input.
  */
 template <typename TSpace = Kokkos::DefaultExecutionSpace, typename T, int N, typename TFunc>
-void for_each(const std::string& label, const GBox<T, N>& region, TFunc&& func)
+void for_each(const auto& label, const GBox<T, N>& region, TFunc&& func)
 {
 #define LINX_CASE_RANK(n) \
   case n: \
     if constexpr (is_nadic<int, n, TFunc>()) { \
-      return Kokkos::parallel_for(label, kokkos_execution_policy<TSpace>(pad<n>(region)), LINX_FORWARD(func)); \
+      return Kokkos::parallel_for( \
+          kernel_label(label), \
+          kokkos_execution_policy<TSpace>(pad<n>(region)), \
+          LINX_FORWARD(func)); \
     } else { \
       return; \
     }
@@ -620,7 +623,7 @@ void for_each(const std::string& label, const GBox<T, N>& region, TFunc&& func)
         throw Linx::OutOfBounds<'[', ']'>("Dynamic rank", region.rank(), {0, 6});
     }
   } else {
-    Kokkos::parallel_for(label, kokkos_execution_policy<TSpace>(region), LINX_FORWARD(func));
+    Kokkos::parallel_for(kernel_label(label), kokkos_execution_policy<TSpace>(region), LINX_FORWARD(func));
   }
 
 #undef LINX_CASE_RANK
@@ -7,6 +7,7 @@
 
 #include "Linx/Base/Containers.h"
 #include "Linx/Base/Functional.h"
+#include "Linx/Base/Memory.h"
 #include "Linx/Base/Slice.h"
 #include "Linx/Base/Types.h"
 #include "Linx/Base/mixins/Data.h"
@@ -98,7 +99,9 @@ public:
   /**
    * @copydoc Image()
    */
-  explicit Image(const std::string& label, std::integral auto... shape) : m_container(label, shape...) {}
+  explicit Image(const std::string& label, std::integral auto... shape) :
+      m_container(budgeted<value_type>(label, shape...), shape...)
+  {}
 
   /**
    * @copydoc Image()
@@ -403,6 +406,21 @@ KOKKOS_INLINE_FUNCTION decltype(auto) as_atomic(const Image<T, N, TContainer>& i
   return Out(Linx::Forward {}, in.container());
 }
 
+/**
+ * @brief Reinterpret a dynamic-rank image as an image of given static rank.
+ * 
+ * The output is a lightweight view of the same data, which does not hold a reference to it.
+ * 
+ * @see `dispatch_static_rank()`
+ */
+template <int M, typename T, typename TContainer>
+  requires(IsDynRankView<TContainer>::value)
+auto as_static_rank(const Image<T, -1, TContainer>& in)
+{
+  auto container = as_static_rank<M>(in.container());
+  return Image<T, M, decltype(container)>(Forward(), LINX_MOVE(container));
+}
+
 /**
  * @brief Copy the data to host if on device.
  */
@@ -436,6 +454,15 @@ auto end(const Image<T, N, TContainer>& image)
   return begin(image) + image.size();
 }
 
+/**
+ * @brief A value image and the image of its variance, e.g. for error propagation.
+ */
+template <typename T, int N>
+struct WithVariance {
+  Image<T, N> value; ///< The values
+  Image<T, N> variance; ///< The variances of the values
+};
+
 /**
  * @brief Contiguous image on host with row-major ordering.
  * 
@@ -0,0 +1,276 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_SCAN_H
+#define _LINXDATA_SCAN_H
+
+#include "Linx/Base/Functional.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Data/Sequence.h"
+
+#include <Kokkos_Core.hpp>
+#include <algorithm> // max, min
+#include <string>
+#include <type_traits>
+#include <utility> // index_sequence
+
+namespace Linx {
+
+namespace Impl {
+
+/**
+ * @brief The minimum number of elements per block when a line is split for parallelization.
+ */
+constexpr Index scan_min_block = 4096;
+
+/**
+ * @brief Compute the number of blocks per line.
+ *
+ * Lines are split only if there are too few of them to keep the execution space busy.
+ */
+template <typename TSpace>
+Index scan_block_count(Index line_count, Index length)
+{
+  const Index concurrency = TSpace().concurrency();
+  if (line_count >= concurrency) {
+    return 1;
+  }
+  const auto wanted = (concurrency + line_count - 1) / line_count;
+  return std::max<Index>(1, std::min(wanted, length / scan_min_block));
+}
+
+/**
+ * @brief Kokkos functor for scanning a 1D container with `Kokkos::parallel_scan()`.
+ */
+template <typename TIn, typename TOut, typename TMonoid, bool Inclusive>
+struct SequenceScan {
+  using value_type = std::remove_cv_t<typename TOut::element_type>; ///< The accumulator type
+
+  TIn m_in; ///< The input
+  TOut m_out; ///< The output
+  TMonoid m_monoid; ///< The scan operator
+
+  /**
+   * @brief Accumulate the `i`-th element.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(Index i, value_type& partial, bool final) const
+  {
+    const value_type value = m_in(i);
+    if constexpr (!Inclusive) {
+      if (final) {
+        m_out(i) = partial;
+      }
+    }
+    partial = m_monoid(partial, value);
+    if constexpr (Inclusive) {
+      if (final) {
+        m_out(i) = partial;
+      }
+    }
+  }
+
+  /**
+   * @brief Initialize an accumulator.
+   */
+  KOKKOS_INLINE_FUNCTION void init(value_type& partial) const
+  {
+    partial = identity_element<value_type>(m_monoid);
+  }
+
+  /**
+   * @brief Join two accumulators.
+   */
+  KOKKOS_INLINE_FUNCTION void join(value_type& dst, const value_type& src) const
+  {
+    dst = m_monoid(dst, src);
+  }
+};
+
+/**
+ * @brief Kokkos functor for scanning blocks of lines along axis `I`.
+ *
+ * The functor is called on a grid of blocks, i.e. the `I`-th index is the block index.
+ * If `Reduce` is true, the total of each block is written to the totals.
+ * Otherwise, each block is scanned starting from its total, which is expected to be the carry of the previous blocks,
+ * unless `TTotals` is `std::nullptr_t`, in which case there are no carries.
+ */
+template <int I, typename TIn, typename TOut, typename TTotals, typename TMonoid, bool Inclusive, bool Reduce>
+struct BlockScan {
+  using value_type = std::remove_cv_t<typename TOut::element_type>; ///< The accumulator type
+
+  TIn m_in; ///< The input
+  TOut m_out; ///< The output
+  TTotals m_totals; ///< The block totals or carries, if any
+  TMonoid m_monoid; ///< The scan operator
+  Index m_length; ///< The line length
+  Index m_block_size; ///< The block length
+
+  /**
+   * @brief Process a block.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(std::integral auto... is) const
+  {
+    constexpr auto N = sizeof...(is);
+    Kokkos::Array<Index, N> position {static_cast<Index>(is)...};
+    const auto begin = position[I] * m_block_size;
+    const auto end = Kokkos::min(begin + m_block_size, m_length);
+    value_type partial = identity_element<value_type>(m_monoid);
+    if constexpr (!Reduce && !std::is_same_v<TTotals, std::nullptr_t>) {
+      partial = m_totals(is...);
+    }
+    for (Index k = begin; k < end; ++k) {
+      position[I] = k;
+      const value_type value = at(m_in, position, std::make_index_sequence<N>());
+      if constexpr (!Reduce && !Inclusive) {
+        at(m_out, position, std::make_index_sequence<N>()) = partial;
+      }
+      partial = m_monoid(partial, value);
+      if constexpr (!Reduce && Inclusive) {
+        at(m_out, position, std::make_index_sequence<N>()) = partial;
+      }
+    }
+    if constexpr (Reduce) {
+      m_totals(is...) = partial;
+    }
+  }
+
+  /**
+   * @brief Access an element from an array of indices.
+   */
+  template <typename TImage, std::size_t... Js>
+  KOKKOS_INLINE_FUNCTION static decltype(auto)
+  at(const TImage& image, const Kokkos::Array<Index, sizeof...(Js)>& position, std::index_sequence<Js...>)
+  {
+    return image(position[Js]...);
+  }
+};
+
+/**
+ * @brief Scan the lines of an image along axis `I` into an image of the same shape.
+ *
+ * @param block_count The number of blocks each line is split into
+ *
+ * With a single block, each line is scanned serially by one thread.
+ * Otherwise, this is a blocked (reduce-then-scan) algorithm:
+ * the blocks are reduced in parallel, the block totals are scanned along the lines,
+ * and the blocks are scanned in parallel, starting from the carries.
+ * Output can alias input.
+ */
+template <int I, bool Inclusive, typename TIn, typename TOut, typename TMonoid>
+void scan_lines(const TIn& in, const TOut& out, const TMonoid& monoid, Index block_count)
+{
+  constexpr auto N = TIn::Rank;
+  using Space = typename TIn::execution_space;
+  using T = std::remove_cv_t<typename TOut::element_type>;
+  using Totals = Image<T, N>;
+
+  const Index length = in.extent(I);
+  const auto block_size = (length + block_count - 1) / std::max<Index>(block_count, 1);
+  auto blocks = in.shape();
+  blocks[I] = block_count;
+  const auto grid = Box<N>(Position<N>(), blocks);
+
+  if (block_count <= 1 || length == 0) {
+    for_each<Space>(
+        Inclusive ? "inclusive_scan()" : "exclusive_scan()",
+        grid,
+        BlockScan<I, TIn, TOut, std::nullptr_t, TMonoid, Inclusive, false> {in, out, nullptr, monoid, length, length});
+    return;
+  }
+
+  Totals totals("scan totals", blocks);
+  for_each<Space>(
+      "scan() reduce",
+      grid,
+      BlockScan<I, TIn, Totals, Totals, TMonoid, true, true> {in, totals, totals, monoid, length, block_size});
+  scan_lines<I, false>(totals, totals, monoid, 1);
+  for_each<Space>(
+      Inclusive ? "inclusive_scan()" : "exclusive_scan()",
+      grid,
+      BlockScan<I, TIn, TOut, Totals, TMonoid, Inclusive, false> {in, out, totals, monoid, length, block_size});
+}
+
+/**
+ * @brief The output type of a scan, i.e. a default, writable container of the shape of the input.
+ */
+template <typename TIn>
+using ScanType = std::conditional_t<
+    AnyImage<TIn>,
+    Image<std::remove_cv_t<typename TIn::element_type>, TIn::Rank>,
+    Sequence<std::remove_cv_t<typename TIn::element_type>, TIn::Rank>>;
+
+/**
+ * @brief Scan a container into a new container of the same shape.
+ */
+template <int I, bool Inclusive, typename TIn, typename TMonoid>
+ScanType<TIn> scan_impl(const std::string& label, const TIn& in, const TMonoid& monoid)
+{
+  using Space = typename TIn::execution_space;
+  ScanType<TIn> out(label, in.shape());
+  if constexpr (AnyImage<TIn> && TIn::Rank > 1) {
+    static_assert(I >= 0 && I < TIn::Rank);
+    const Index length = in.extent(I);
+    const auto line_count = length ? Index(in.size()) / length : 0;
+    scan_lines<I, Inclusive>(as_readonly(in), out, monoid, scan_block_count<Space>(line_count, length));
+  } else {
+    static_assert(I == 0);
+    using Functor = SequenceScan<std::decay_t<decltype(as_readonly(in))>, ScanType<TIn>, TMonoid, Inclusive>;
+    Kokkos::parallel_scan(
+        Inclusive ? "inclusive_scan()" : "exclusive_scan()",
+        Kokkos::RangePolicy<Space>(0, in.size()),
+        Functor {as_readonly(in), out, monoid});
+  }
+  return out;
+}
+
+} // namespace Impl
+
+/**
+ * @brief Compute the inclusive scan of a container along a given axis.
+ *
+ * @tparam I The scan axis, which must be 0 for sequences
+ * @param in The input sequence or image
+ * @param monoid The scan operator, e.g. `Add()` for the cumulative sum
+ * @return The container of the same shape, whose element `i` along the axis accumulates the elements `0` to `i`
+ *
+ * The monoid is an associative binary operator functor, for which `identity_element()` is defined.
+ * The output is a default, writable sequence or image, even if the input is read-only or has another container.
+ * Sequences and 1D images rely on `Kokkos::parallel_scan()`.
+ * Higher-rank images are parallelized over the orthogonal lines,
+ * and long lines are further split into blocks if there are too few lines to saturate the execution space.
+ *
+ * \code
+ * auto cdf = inclusive_scan(histogram, Add());
+ * auto integral = inclusive_scan<1>(inclusive_scan<0>(image, Add()), Add());
+ * \endcode
+ *
+ * @see `exclusive_scan()`
+ */
+template <int I = 0, typename TIn, typename TMonoid>
+Impl::ScanType<TIn> inclusive_scan(const TIn& in, const TMonoid& monoid)
+{
+  return Impl::scan_impl<I, true>(compose_label("inclusive_scan", in), in, monoid);
+}
+
+/**
+ * @brief Compute the exclusive scan of a container along a given axis.
+ *
+ * @return The container of the same shape, whose element `i` along the axis accumulates the elements `0` to `i - 1`,
+ * and whose first element is the identity element of the monoid
+ *
+ * Typically, the exclusive cumulative sum of a mask yields the output indices of a compaction.
+ *
+ * @copydetails inclusive_scan()
+ */
+template <int I = 0, typename TIn, typename TMonoid>
+Impl::ScanType<TIn> exclusive_scan(const TIn& in, const TMonoid& monoid)
+{
+  return Impl::scan_impl<I, false>(compose_label("exclusive_scan", in), in, monoid);
+}
+
+} // namespace Linx
+
+#endif
@@ -7,6 +7,7 @@
 
 #include "Linx/Base/Containers.h"
 #include "Linx/Base/Functional.h"
+#include "Linx/Base/Memory.h"
 #include "Linx/Base/Slice.h"
 #include "Linx/Base/Types.h"
 #include "Linx/Base/concepts/Array.h"
@@ -73,7 +74,8 @@ public:
   /**
    * @copydoc Sequence()
    */
-  explicit Sequence(const std::string& label, std::integral auto size) : m_container(label)
+  explicit Sequence(const std::string& label, std::integral auto size) :
+      m_container(budgeted<value_type>(label, Rank < 1 ? size : Rank))
   {
     if constexpr (Rank < 1) {
       Kokkos::resize(m_container, size);
@@ -0,0 +1,393 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXDATA_SORTING_H
+#define _LINXDATA_SORTING_H
+
+#include "Linx/Base/Functional.h"
+#include "Linx/Base/mixins/Range.h" // is_contiguous
+#include "Linx/Data/Sequence.h"
+
+#include <Kokkos_BitManipulation.hpp> // bit_cast
+#include <Kokkos_Core.hpp>
+#include <algorithm> // max, min
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+namespace Impl {
+
+/**
+ * @brief The unsigned integer type of the radix sort keys.
+ */
+template <typename T>
+using RadixBits = std::conditional_t<
+    sizeof(T) == 1,
+    std::uint8_t,
+    std::conditional_t<
+        sizeof(T) == 2,
+        std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+/**
+ * @brief Map a value to an unsigned integer with the same ordering.
+ *
+ * The sign bit of signed integers is flipped.
+ * Floating point numbers are flipped entirely if negative, and only their sign bit is flipped otherwise.
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION RadixBits<T> radix_encode(T value)
+{
+  using U = RadixBits<T>;
+  constexpr U sign = U(1) << (sizeof(T) * 8 - 1);
+  if constexpr (std::is_floating_point_v<T>) {
+    const auto bits = Kokkos::bit_cast<U>(value);
+    return (bits & sign) ? U(~bits) : U(bits | sign);
+  } else if constexpr (std::is_signed_v<T>) {
+    return U(value) ^ sign;
+  } else {
+    return U(value);
+  }
+}
+
+/**
+ * @brief Inverse of `radix_encode()`.
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION T radix_decode(RadixBits<T> bits)
+{
+  using U = RadixBits<T>;
+  constexpr U sign = U(1) << (sizeof(T) * 8 - 1);
+  if constexpr (std::is_floating_point_v<T>) {
+    return Kokkos::bit_cast<T>((bits & sign) ? U(bits ^ sign) : U(~bits));
+  } else if constexpr (std::is_signed_v<T>) {
+    return T(bits ^ sign);
+  } else {
+    return T(bits);
+  }
+}
+
+/**
+ * @brief Split a range into chunks, one per thread of the parallel passes.
+ */
+template <typename TSpace>
+Index sort_chunk_size(Index size)
+{
+  const Index chunk_count = 4 * TSpace().concurrency();
+  return std::max<Index>(256, (size + chunk_count - 1) / chunk_count);
+}
+
+/**
+ * @brief Stable parallel LSD radix sort of 8-bit digits.
+ *
+ * @param keys The keys, sorted in place
+ * @param values The values, permuted like the keys, or `nullptr`
+ * @param size The number of keys
+ *
+ * Each pass splits the range into chunks, computes the per-chunk digit histograms,
+ * scans them in digit-major order to get the output offsets, and scatters each chunk serially,
+ * which preserves the order of equal digits.
+ */
+template <typename TSpace, typename TKey, typename TValue>
+void radix_sort(TKey* keys, TValue* values, Index size)
+{
+  using Bits = RadixBits<TKey>;
+  using Memory = typename TSpace::memory_space;
+  constexpr Index bucket_count = 256;
+  constexpr int pass_count = sizeof(TKey);
+  if (size < 2) {
+    return;
+  }
+
+  const auto chunk_size = sort_chunk_size<TSpace>(size);
+  const Index chunk_count = (size + chunk_size - 1) / chunk_size;
+  Kokkos::View<Bits*, Memory> bits_a(Kokkos::view_alloc(Kokkos::WithoutInitializing, "sort() keys"), size);
+  Kokkos::View<Bits*, Memory> bits_b(Kokkos::view_alloc(Kokkos::WithoutInitializing, "sort() keys"), size);
+  Kokkos::View<TValue*, Memory> values_b(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "sort() values"),
+      values ? size : 0);
+  Kokkos::View<Index*, Memory> offsets("sort() offsets", bucket_count * chunk_count);
+
+  auto src = bits_a.data();
+  auto dst = bits_b.data();
+  auto src_values = values;
+  auto dst_values = values_b.data();
+  auto offsets_ptr = offsets.data();
+
+  Kokkos::parallel_for(
+      "sort()",
+      Kokkos::RangePolicy<TSpace>(0, size),
+      KOKKOS_LAMBDA(Index i) { src[i] = radix_encode(keys[i]); });
+
+  for (int pass = 0; pass < pass_count; ++pass) {
+    const int shift = 8 * pass;
+    Kokkos::deep_copy(offsets, 0);
+    Kokkos::parallel_for(
+        "sort() histogram",
+        Kokkos::RangePolicy<TSpace>(0, chunk_count),
+        KOKKOS_LAMBDA(Index c) {
+          const auto end = Kokkos::min(size, (c + 1) * chunk_size);
+          for (Index i = c * chunk_size; i < end; ++i) {
+            ++offsets_ptr[((src[i] >> shift) & 0xFF) * chunk_count + c];
+          }
+        });
+    Kokkos::parallel_scan(
+        "sort() scan",
+        Kokkos::RangePolicy<TSpace>(0, bucket_count * chunk_count),
+        KOKKOS_LAMBDA(Index i, Index& partial, bool final) {
+          const auto count = offsets_ptr[i];
+          if (final) {
+            offsets_ptr[i] = partial;
+          }
+          partial += count;
+        });
+    Kokkos::parallel_for(
+        "sort() scatter",
+        Kokkos::RangePolicy<TSpace>(0, chunk_count),
+        KOKKOS_LAMBDA(Index c) {
+          const auto end = Kokkos::min(size, (c + 1) * chunk_size);
+          for (Index i = c * chunk_size; i < end; ++i) {
+            const auto j = offsets_ptr[((src[i] >> shift) & 0xFF) * chunk_count + c]++;
+            dst[j] = src[i];
+            if (src_values) {
+              dst_values[j] = src_values[i];
+            }
+          }
+        });
+    std::swap(src, dst);
+    std::swap(src_values, dst_values);
+  }
+
+  Kokkos::parallel_for(
+      "sort()",
+      Kokkos::RangePolicy<TSpace>(0, size),
+      KOKKOS_LAMBDA(Index i) {
+        keys[i] = radix_decode<TKey>(src[i]);
+        if (src_values && src_values != values) {
+          values[i] = src_values[i];
+        }
+      });
+}
+
+/**
+ * @brief Number of elements of a sorted range which are strictly less than a value.
+ */
+template <typename T, typename TCompare>
+KOKKOS_INLINE_FUNCTION Index lower_rank(const T* begin, Index size, const T& value, const TCompare& compare)
+{
+  Index low = 0;
+  while (low < size) {
+    const auto mid = low + (size - low) / 2;
+    if (compare(begin[mid], value)) {
+      low = mid + 1;
+    } else {
+      size = mid;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Number of elements of a sorted range which are less than or equal to a value.
+ */
+template <typename T, typename TCompare>
+KOKKOS_INLINE_FUNCTION Index upper_rank(const T* begin, Index size, const T& value, const TCompare& compare)
+{
+  Index low = 0;
+  while (low < size) {
+    const auto mid = low + (size - low) / 2;
+    if (compare(value, begin[mid])) {
+      size = mid;
+    } else {
+      low = mid + 1;
+    }
+  }
+  return low;
+}
+
+/**
+ * @brief Stable parallel merge sort.
+ *
+ * @param keys The keys, sorted in place
+ * @param values The values, permuted like the keys, or `nullptr`
+ * @param size The number of keys
+ * @param compare The strict weak ordering
+ *
+ * Small blocks are first insertion-sorted in parallel.
+ * Then, at each merge pass, every element computes its output position independently,
+ * as its rank in its own run plus its rank in the sibling run, obtained by binary search.
+ */
+template <typename TSpace, typename TKey, typename TValue, typename TCompare>
+void merge_sort(TKey* keys, TValue* values, Index size, TCompare compare)
+{
+  using Memory = typename TSpace::memory_space;
+  constexpr Index block_size = 32;
+  if (size < 2) {
+    return;
+  }
+
+  Kokkos::parallel_for(
+      "sort()",
+      Kokkos::RangePolicy<TSpace>(0, (size + block_size - 1) / block_size),
+      KOKKOS_LAMBDA(Index b) {
+        const auto begin = b * block_size;
+        const auto end = Kokkos::min(size, begin + block_size);
+        for (Index i = begin + 1; i < end; ++i) {
+          const auto key = keys[i];
+          Index j = i;
+          if (values) {
+            const auto value = values[i];
+            for (; j > begin && compare(key, keys[j - 1]); --j) {
+              keys[j] = keys[j - 1];
+              values[j] = values[j - 1];
+            }
+            values[j] = value;
+          } else {
+            for (; j > begin && compare(key, keys[j - 1]); --j) {
+              keys[j] = keys[j - 1];
+            }
+          }
+          keys[j] = key;
+        }
+      });
+  if (size <= block_size) {
+    return;
+  }
+
+  Kokkos::View<TKey*, Memory> keys_b(Kokkos::view_alloc(Kokkos::WithoutInitializing, "sort() keys"), size);
+  Kokkos::View<TValue*, Memory> values_b(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "sort() values"),
+      values ? size : 0);
+  auto src = keys;
+  auto dst = keys_b.data();
+  auto src_values = values;
+  auto dst_values = values_b.data();
+
+  for (Index width = block_size; width < size; width *= 2) {
+    Kokkos::parallel_for(
+        "sort() merge",
+        Kokkos::RangePolicy<TSpace>(0, size),
+        KOKKOS_LAMBDA(Index i) {
+          const auto begin = (i / (2 * width)) * 2 * width;
+          const auto mid = Kokkos::min(size, begin + width);
+          const auto end = Kokkos::min(size, begin + 2 * width);
+          const auto& key = src[i];
+          const auto j = i < mid ? i + lower_rank(src + mid, end - mid, key, compare) :
+                                   i - width + upper_rank(src + begin, mid - begin, key, compare);
+          dst[j] = key;
+          if (src_values) {
+            dst_values[j] = src_values[i];
+          }
+        });
+    std::swap(src, dst);
+    std::swap(src_values, dst_values);
+  }
+
+  if (src != keys) {
+    Kokkos::parallel_for(
+        "sort()",
+        Kokkos::RangePolicy<TSpace>(0, size),
+        KOKKOS_LAMBDA(Index i) {
+          keys[i] = src[i];
+          if (src_values) {
+            values[i] = src_values[i];
+          }
+        });
+  }
+}
+
+/**
+ * @brief Sort keys and optional values, with the radix sort if possible.
+ */
+template <typename TSpace, typename TKey, typename TValue, typename TCompare>
+void sort_impl(TKey* keys, TValue* values, Index size, const TCompare& compare)
+{
+  if constexpr (std::is_arithmetic_v<TKey> && std::is_same_v<TCompare, Less<>>) {
+    radix_sort<TSpace>(keys, values, size);
+  } else {
+    merge_sort<TSpace>(keys, values, size, compare);
+  }
+}
+
+} // namespace Impl
+
+/**
+ * @brief Sort the elements of a contiguous container in place.
+ *
+ * @param in The container
+ * @param compare An optional strict weak ordering, e.g. `Greater()` for decreasing order
+ *
+ * The sort is stable.
+ * Arithmetic values in increasing order are sorted with a parallel LSD radix sort,
+ * where floating point values are ordered by their sign-flipped bit patterns,
+ * such that negative NaNs come first and positive NaNs come last.
+ * Other cases rely on a parallel merge sort.
+ */
+template <typename TIn, typename TCompare = Less<>>
+requires(is_contiguous<typename TIn::Container>())
+const TIn& sort(const TIn& in, const TCompare& compare = TCompare())
+{
+  using Space = typename TIn::execution_space;
+  Impl::sort_impl<Space>(in.data(), static_cast<Index*>(nullptr), in.size(), compare);
+  return in;
+}
+
+/**
+ * @brief Sort a contiguous container of keys and permute a contiguous container of values accordingly.
+ *
+ * @param keys The keys
+ * @param values The values
+ * @param compare An optional strict weak ordering of the keys
+ *
+ * @see `sort()`
+ */
+template <typename TKeys, typename TValues, typename TCompare = Less<>>
+requires(is_contiguous<typename TKeys::Container>() && is_contiguous<typename TValues::Container>())
+void sort_by_key(const TKeys& keys, const TValues& values, const TCompare& compare = TCompare())
+{
+  SizeMismatch::may_throw("values", values.size(), keys);
+  using Space = typename TKeys::execution_space;
+  Impl::sort_impl<Space>(keys.data(), values.data(), keys.size(), compare);
+}
+
+/**
+ * @brief Get the indices which sort a contiguous container.
+ *
+ * @param in The container, which is left unchanged
+ * @param compare An optional strict weak ordering
+ *
+ * The indices of equal elements are in increasing order.
+ *
+ * @see `sort()`
+ */
+template <typename TIn, typename TCompare = Less<>>
+requires(is_contiguous<typename TIn::Container>())
+Sequence<Index, -1> argsort(const TIn& in, const TCompare& compare = TCompare())
+{
+  using Space = typename TIn::execution_space;
+  using T = typename TIn::element_type;
+  const Index size = in.size();
+  Sequence<Index, -1> out(compose_label("argsort", in), size);
+  Kokkos::View<T*, typename Space::memory_space> keys(
+      Kokkos::view_alloc(Kokkos::WithoutInitializing, "argsort() keys"),
+      size);
+  auto keys_ptr = keys.data();
+  auto in_ptr = in.data();
+  auto out_ptr = out.data();
+  Kokkos::parallel_for(
+      "argsort()",
+      Kokkos::RangePolicy<Space>(0, size),
+      KOKKOS_LAMBDA(Index i) {
+        keys_ptr[i] = in_ptr[i];
+        out_ptr[i] = i;
+      });
+  Impl::sort_impl<Space>(keys_ptr, out_ptr, size, compare);
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,389 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXRUN_PROFILER_H
+#define _LINXRUN_PROFILER_H
+
+#include "Linx/Base/Instrumentation.h"
+#include "Linx/Base/Memory.h"
+
+#include <Kokkos_Core.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief In-process Kokkos Tools callback library.
+ *
+ * Once started, the profiler records, for each label passed to Kokkos (and therefore for each Linx operation):
+ * - the number of kernel launches, and the total and percentile durations of the kernels;
+ * - the number and durations of fences;
+ * - the number and sizes of allocations and deallocations, per memory space, thanks to the `MemoryTracker`;
+ * - if `LINX_INSTRUMENTATION` is defined, the hot-path counters of the filters (see `counter_report()`).
+ *
+ * The profiler is a singleton, which is typically driven by `ProgramContext` (see the `--profile` flag),
+ * but can also be used directly:
+ *
+ * \code
+ * Linx::Profiler::instance().start();
+ * ... // Some Linx calls
+ * Linx::Profiler::instance().stop();
+ * Linx::Profiler::instance().report(std::cout);
+ * Linx::Profiler::instance().write_trace("trace.json"); // Open in chrome://tracing or Perfetto
+ * \endcode
+ *
+ * Kokkos must be initialized before the profiler is started.
+ *
+ * @warning Only one set of Kokkos Tools callbacks can be active at a time:
+ * starting the profiler overrides the callbacks of any tool library loaded with `--kokkos-tools-libs`.
+ */
+class Profiler {
+public:
+
+  /**
+   * @brief The statistics of some timed events.
+   */
+  struct Timings {
+    std::vector<double> durations; ///< The durations in seconds, in chronological order
+
+    /**
+     * @brief Number of events.
+     */
+    std::size_t count() const
+    {
+      return durations.size();
+    }
+
+    /**
+     * @brief Total duration.
+     */
+    double total() const
+    {
+      double out = 0;
+      for (auto d : durations) {
+        out += d;
+      }
+      return out;
+    }
+
+    /**
+     * @brief Duration percentile, using the nearest-rank method.
+     * @param p The percentile, in [0, 100]
+     */
+    double percentile(double p) const
+    {
+      if (durations.empty()) {
+        return 0;
+      }
+      auto sorted = durations;
+      std::sort(sorted.begin(), sorted.end());
+      const auto rank = static_cast<std::size_t>(p / 100. * sorted.size() + .5);
+      return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+    }
+  };
+
+  /**
+   * @brief Get the profiler.
+   */
+  static Profiler& instance()
+  {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  /**
+   * @brief Register the callbacks and start recording.
+   * 
+   * The `MemoryTracker` is started, too, if not already.
+   */
+  void start()
+  {
+    namespace Tools = Kokkos::Tools::Experimental;
+    auto& tracker = MemoryTracker::instance();
+    m_owns_tracker = not tracker.enabled();
+    tracker.start();
+    m_origin = Clock::now();
+    Tools::set_begin_parallel_for_callback(begin_parallel_for);
+    Tools::set_end_parallel_for_callback(end_kernel);
+    Tools::set_begin_parallel_reduce_callback(begin_parallel_reduce);
+    Tools::set_end_parallel_reduce_callback(end_kernel);
+    Tools::set_begin_parallel_scan_callback(begin_parallel_scan);
+    Tools::set_end_parallel_scan_callback(end_kernel);
+    Tools::set_begin_fence_callback(begin_fence);
+    Tools::set_end_fence_callback(end_fence);
+    m_enabled = true;
+  }
+
+  /**
+   * @brief Unregister the callbacks and stop recording.
+   *
+   * Recorded data is kept until `clear()` is called.
+   * The `MemoryTracker` is stopped if it was started by `start()`.
+   */
+  void stop()
+  {
+    namespace Tools = Kokkos::Tools::Experimental;
+    m_enabled = false;
+    Tools::set_begin_parallel_for_callback(nullptr);
+    Tools::set_end_parallel_for_callback(nullptr);
+    Tools::set_begin_parallel_reduce_callback(nullptr);
+    Tools::set_end_parallel_reduce_callback(nullptr);
+    Tools::set_begin_parallel_scan_callback(nullptr);
+    Tools::set_end_parallel_scan_callback(nullptr);
+    Tools::set_begin_fence_callback(nullptr);
+    Tools::set_end_fence_callback(nullptr);
+    if (m_owns_tracker) {
+      MemoryTracker::instance().stop();
+      m_owns_tracker = false;
+    }
+  }
+
+  /**
+   * @brief Check whether the profiler is recording.
+   */
+  bool enabled() const
+  {
+    return m_enabled;
+  }
+
+  /**
+   * @brief Forget all the recorded data.
+   */
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_kernels.clear();
+    m_fences.clear();
+    m_pending.clear();
+    m_events.clear();
+  }
+
+  /**
+   * @brief The kernel timings, per label.
+   */
+  const std::map<std::string, Timings>& kernels() const
+  {
+    return m_kernels;
+  }
+
+  /**
+   * @brief The fence timings, per label.
+   */
+  const std::map<std::string, Timings>& fences() const
+  {
+    return m_fences;
+  }
+
+  /**
+   * @brief Print a report where labels are ranked by decreasing total duration.
+   */
+  void report(std::ostream& out) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    out << "\nKernels:\n\n";
+    print_timings(out, m_kernels);
+
+    out << "\nFences:\n\n";
+    print_timings(out, m_fences);
+
+    out << "\n" << memory_report() << std::endl;
+
+    if constexpr (instrumented) {
+      out << "\n" << counter_report() << std::endl;
+    }
+  }
+
+  /**
+   * @brief Get a snapshot of the hot-path counters, which is empty unless `LINX_INSTRUMENTATION` is defined.
+   */
+  CounterReport counters() const
+  {
+    return counter_report();
+  }
+
+  /**
+   * @brief Write the kernels and fences as a Chrome trace JSON file.
+   *
+   * The file can be opened with `chrome://tracing` or https://ui.perfetto.dev.
+   */
+  void write_trace(const std::string& filename) const
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::ofstream out(filename);
+    out << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < m_events.size(); ++i) {
+      const auto& e = m_events[i];
+      out << (i ? ",\n" : "\n") << "{\"name\":\"" << escape(e.name) << "\",\"cat\":\"" << e.category
+          << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" << std::fixed << std::setprecision(3) << e.start
+          << ",\"dur\":" << e.duration << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+private:
+
+  using Clock = std::chrono::steady_clock; ///< The clock
+
+  /**
+   * @brief A kernel or fence which has begun but not ended yet.
+   */
+  struct Pending {
+    std::string name; ///< The label
+    const char* category; ///< The event category
+    Clock::time_point start; ///< The start time
+  };
+
+  /**
+   * @brief A completed event, for tracing.
+   */
+  struct Event {
+    std::string name; ///< The label
+    const char* category; ///< The event category
+    double start; ///< The start time in microseconds since `start()`
+    double duration; ///< The duration in microseconds
+  };
+
+  /**
+   * @brief Constructor.
+   */
+  Profiler() = default;
+
+  /**
+   * @brief Record the beginning of a kernel or fence.
+   */
+  void begin(const char* name, const char* category, std::uint64_t* id)
+  {
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    *id = m_next_id++;
+    m_pending.emplace(*id, Pending {name, category, now});
+  }
+
+  /**
+   * @brief Record the end of a kernel or fence.
+   */
+  void end(std::uint64_t id, std::map<std::string, Timings>& records)
+  {
+    const auto now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_pending.find(id);
+    if (it == m_pending.end()) {
+      return;
+    }
+    const auto& p = it->second;
+    const std::chrono::duration<double> duration = now - p.start;
+    const std::chrono::duration<double, std::micro> start = p.start - m_origin;
+    records[p.name].durations.push_back(duration.count());
+    m_events.push_back({p.name, p.category, start.count(), duration.count() * 1.e6});
+    m_pending.erase(it);
+  }
+
+  /// @cond
+  static void begin_parallel_for(const char* name, std::uint32_t, std::uint64_t* id)
+  {
+    instance().begin(name, "parallel_for", id);
+  }
+
+  static void begin_parallel_reduce(const char* name, std::uint32_t, std::uint64_t* id)
+  {
+    instance().begin(name, "parallel_reduce", id);
+  }
+
+  static void begin_parallel_scan(const char* name, std::uint32_t, std::uint64_t* id)
+  {
+    instance().begin(name, "parallel_scan", id);
+  }
+
+  static void end_kernel(std::uint64_t id)
+  {
+    auto& profiler = instance();
+    profiler.end(id, profiler.m_kernels);
+  }
+
+  static void begin_fence(const char* name, std::uint32_t, std::uint64_t* id)
+  {
+    instance().begin(name, "fence", id);
+  }
+
+  static void end_fence(std::uint64_t id)
+  {
+    auto& profiler = instance();
+    profiler.end(id, profiler.m_fences);
+  }
+  /// @endcond
+
+  /**
+   * @brief Print timings ranked by decreasing total duration.
+   */
+  static void print_timings(std::ostream& out, const std::map<std::string, Timings>& records)
+  {
+    std::vector<std::pair<double, const std::string*>> ranking;
+    ranking.reserve(records.size());
+    for (const auto& [label, t] : records) {
+      ranking.emplace_back(t.total(), &label);
+    }
+    std::sort(ranking.begin(), ranking.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.first > rhs.first;
+    });
+
+    out << std::left << std::setw(40) << "  Label" << std::right << std::setw(10) << "Count" << std::setw(14)
+        << "Total (s)" << std::setw(14) << "p50 (s)" << std::setw(14) << "p90 (s)" << std::setw(14) << "p99 (s)"
+        << std::setw(14) << "Max (s)"
+        << "\n";
+    for (const auto& [total, label] : ranking) {
+      const auto& t = records.at(*label);
+      out << "  " << std::left << std::setw(38) << *label << std::right << std::setw(10) << t.count() << std::scientific
+          << std::setprecision(3) << std::setw(14) << total << std::setw(14) << t.percentile(50) << std::setw(14)
+          << t.percentile(90) << std::setw(14) << t.percentile(99) << std::setw(14) << t.percentile(100)
+          << std::defaultfloat << "\n";
+    }
+  }
+
+  /**
+   * @brief Escape a string for JSON.
+   */
+  static std::string escape(const std::string& in)
+  {
+    std::string out;
+    out.reserve(in.size());
+    for (char c : in) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += c;
+      } else if (static_cast<unsigned char>(c) < 0x20) {
+        out += ' ';
+      } else {
+        out += c;
+      }
+    }
+    return out;
+  }
+
+private:
+
+  mutable std::mutex m_mutex; ///< The lock for concurrent callbacks
+  bool m_enabled = false; ///< The recording status
+  bool m_owns_tracker = false; ///< Whether the memory tracker was started by the profiler
+  Clock::time_point m_origin; ///< The trace origin
+  std::uint64_t m_next_id = 0; ///< The next event identifier
+  std::unordered_map<std::uint64_t, Pending> m_pending; ///< The events in progress
+  std::map<std::string, Timings> m_kernels; ///< The kernel timings
+  std::map<std::string, Timings> m_fences; ///< The fence timings
+  std::vector<Event> m_events; ///< The completed events
+};
+
+} // namespace Linx
+
+#endif
@@ -6,11 +6,16 @@
 #define _LINXRUN_PROGRAMCONTEXT_H
 
 #include "Linx/Base/Types.h" // LINX_FORWARD
+#include "Linx/Run/Profiler.h"
 
 #include <Kokkos_Core.hpp>
 #include <boost/program_options.hpp>
+#include <cstdlib> // setenv
+#include <filesystem>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 namespace Linx {
 
@@ -42,6 +47,30 @@ namespace po = boost::program_options;
  * 
  * After parsing, arguments are queried with `as()`.
  * 
+ * When a command line is given, Kokkos is initialized by `parse()` rather than by the constructor,
+ * such that the following runtime options can be forwarded to Kokkos:
+ * - `--threads`: the number of threads of the host execution space, or 0 for the Kokkos default;
+ * - `--affinity`: the thread binding policy, e.g. `close` or `spread`, exported as `OMP_PROC_BIND`;
+ * - `--numa`: the thread placement policy, e.g. `cores` or `sockets`, exported as `OMP_PLACES`;
+ * - `--device`: the device id, or -1 for the Kokkos default;
+ * - `--tune`: enable the tuning of Kokkos internals by the loaded tools;
+ * - `--tools`: the Kokkos Tools libraries to be loaded.
+ * 
+ * Standard Kokkos arguments, e.g. `--kokkos-num-threads=4` or `--kokkos-tools-args=<args>`, are forwarded, too,
+ * the above options taking precedence.
+ * 
+ * Unless the flag `--quiet` is set, a banner which describes the actual configuration
+ * (execution and memory spaces, concurrency...) is then printed, such that benchmark logs are self-describing.
+ * Kokkos environment variables (`KOKKOS_NUM_THREADS`...) remain supported, command line options taking precedence.
+ * 
+ * The flag `--profile` is also declared.
+ * If set, the Kokkos kernels, fences and allocations are recorded by the `Profiler` from `parse()` on.
+ * When the context is destroyed, a ranked report is printed to the standard output
+ * and a Chrome trace is written to `<program>.trace.json`,
+ * or to `linx.trace.json` if no command line was given (e.g. in the test fixtures).
+ * Similarly, the option `--memory-budget` sets a soft budget to the `MemoryTracker`,
+ * whose report is printed when the context is destroyed.
+ * 
  * Here is an example command line with every kind of options:
  * 
  * `tree -d -L 2 --sort=size ~`
@@ -273,20 +302,46 @@ public:
       m_argv(argv), m_named("Options", 120), m_add(m_named.add_options()), m_positional(), m_variables(),
       m_desc(description), m_help(help)
   {
-    if (m_argc) {
-      // FIXME remove --help
-      Kokkos::initialize(m_argc, const_cast<char**>(m_argv));
-    } else {
-      Kokkos::initialize();
+    if (not m_argc) {
+      initialize(Kokkos::InitializationSettings());
     }
     if (m_help.length() > 0) {
       flag(m_help, "Print help message");
       m_help = Help::long_name(m_help);
     }
+    if (m_argc) {
+      named("threads", "Number of host threads, or 0 for the Kokkos default", 0);
+      named("affinity", "Thread binding policy (OMP_PROC_BIND), e.g. close or spread", std::string());
+      named("numa", "Thread placement policy (OMP_PLACES), e.g. cores, sockets or numa_domains", std::string());
+      named("device", "Device id, or -1 for the Kokkos default", -1);
+      flag("tune", "Enable the tuning of Kokkos internals by the loaded tools");
+      named("tools", "Kokkos Tools libraries to be loaded", std::string());
+      flag("quiet", "Do not print the runtime configuration banner");
+      flag("profile", "Profile Kokkos kernels, print a report and write a Chrome trace");
+      named("memory-budget", "Soft memory budget in MiB, or 0 for unlimited", 0L);
+    }
   }
 
   ~ProgramContext()
   {
+    if (not m_initialized) {
+      return;
+    }
+    auto& profiler = Profiler::instance();
+    if (profiler.enabled()) {
+      Kokkos::fence();
+      profiler.stop();
+      profiler.report(std::cout);
+      const auto program = m_argc ? std::filesystem::path(m_argv[0]).filename().string() : std::string("linx");
+      const auto trace = program + ".trace.json";
+      profiler.write_trace(trace);
+      std::cout << "Chrome trace written to: " << trace << std::endl;
+    }
+    auto& tracker = MemoryTracker::instance();
+    if (tracker.enabled()) {
+      std::cout << "\n" << memory_report() << std::endl;
+      tracker.stop();
+    }
     Kokkos::finalize();
   }
 
@@ -362,8 +417,17 @@ public:
   void parse()
   {
     // FIXME throw or quietly pass if m_argc == 0?
+    std::vector<std::string> kokkos_args;
     try {
-      po::store(po::command_line_parser(m_argc, m_argv).options(m_named).positional(m_positional).run(), m_variables);
+      const auto parsed =
+          po::command_line_parser(m_argc, m_argv).options(m_named).positional(m_positional).allow_unregistered().run();
+      for (const auto& arg : po::collect_unrecognized(parsed.options, po::exclude_positional)) {
+        if (arg.rfind("--kokkos-", 0) != 0) {
+          throw po::unknown_option(arg);
+        }
+        kokkos_args.push_back(arg);
+      }
+      po::store(parsed, m_variables);
       if (not m_help.empty() && has(m_help)) {
         m_desc.to_stream(m_argv[0]);
         exit(0);
@@ -374,6 +438,40 @@ public:
       m_desc.to_stream(m_argv[0], std::cerr);
       std::rethrow_exception(std::current_exception());
     }
+    const bool initializing = not m_initialized;
+    if (initializing) {
+      initialize(with_runtime_options(std::move(kokkos_args)));
+    }
+    if (m_variables.count("profile") && has("profile")) {
+      Profiler::instance().start();
+    }
+    if (m_variables.count("memory-budget")) {
+      MemoryTracker::instance().set_budget(as<long>("memory-budget") << 20);
+    }
+    if (initializing && not has("quiet")) {
+      banner(std::cout);
+    }
+  }
+
+  /**
+   * @brief Print the runtime configuration.
+   */
+  void banner(std::ostream& out) const
+  {
+    using Space = Kokkos::DefaultExecutionSpace;
+    using HostSpace = Kokkos::DefaultHostExecutionSpace;
+    const auto env = [](const char* name) {
+      const char* value = std::getenv(name);
+      return std::string(value ? value : "default");
+    };
+    out << "Kokkos " << KOKKOS_VERSION / 10000 << "." << KOKKOS_VERSION / 100 % 100 << "." << KOKKOS_VERSION % 100
+        << "\n";
+    out << "  Execution space: " << Space::name() << " (concurrency: " << Space().concurrency() << ")\n";
+    out << "  Memory space: " << Space::memory_space::name() << "\n";
+    out << "  Host execution space: " << HostSpace::name() << " (concurrency: " << HostSpace().concurrency() << ")\n";
+    out << "  Thread binding: " << env("OMP_PROC_BIND") << ", placement: " << env("OMP_PLACES") << "\n";
+    out << "  Tuning: " << (Kokkos::tune_internals() ? "enabled" : "disabled") << "\n";
+    out << "  Profiling: " << (Profiler::instance().enabled() ? "enabled" : "disabled") << std::endl;
   }
 
   /**
@@ -401,6 +499,60 @@ public:
 
 private:
 
+  /**
+   * @brief Append the runtime options to the forwarded Kokkos arguments.
+   */
+  std::vector<std::string> with_runtime_options(std::vector<std::string> args) const
+  {
+    if (const auto threads = as<int>("threads"); threads > 0) {
+      args.push_back("--kokkos-num-threads=" + std::to_string(threads));
+    }
+    if (const auto device = as<int>("device"); device >= 0) {
+      args.push_back("--kokkos-device-id=" + std::to_string(device));
+    }
+    if (const auto affinity = as<std::string>("affinity"); not affinity.empty()) {
+      setenv("OMP_PROC_BIND", affinity.c_str(), 1); // Read by the OpenMP runtime at initialization
+    }
+    if (const auto numa = as<std::string>("numa"); not numa.empty()) {
+      setenv("OMP_PLACES", numa.c_str(), 1);
+    }
+    if (has("tune")) {
+      args.push_back("--kokkos-tune-internals");
+    }
+    if (const auto tools = as<std::string>("tools"); not tools.empty()) {
+      args.push_back("--kokkos-tools-libs=" + tools);
+    }
+    return args;
+  }
+
+  /**
+   * @brief Initialize Kokkos with default settings.
+   */
+  void initialize(const Kokkos::InitializationSettings& settings)
+  {
+    Kokkos::initialize(settings);
+    m_initialized = true;
+  }
+
+  /**
+   * @brief Initialize Kokkos from command line arguments.
+   * 
+   * The last occurrence of an argument takes precedence.
+   */
+  void initialize(const std::vector<std::string>& args)
+  {
+    std::vector<std::string> tokens {m_argv[0]};
+    tokens.insert(tokens.end(), args.begin(), args.end());
+    std::vector<char*> argv;
+    for (auto& t : tokens) {
+      argv.push_back(t.data());
+    }
+    argv.push_back(nullptr);
+    int argc = tokens.size();
+    Kokkos::initialize(argc, argv.data());
+    m_initialized = true;
+  }
+
   /**
    * @brief Declare a positional option with custom semantics.
    */
@@ -431,6 +583,7 @@ private:
   po::variables_map m_variables;
   Help m_desc;
   std::string m_help;
+  bool m_initialized = false;
 };
 
 } // namespace Linx
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BACKGROUND_H
+#define _LINXTRANSFORMS_BACKGROUND_H
+
+#include "Linx/Base/Algorithm.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @brief The parameters of a background estimation.
+ */
+struct BackgroundParameters {
+  double nsigma = 3; ///< The clipping threshold in standard deviations
+  int iterations = 5; ///< The maximum number of clipping iterations
+  int filter_radius = 1; ///< The radius of the median filter of the mesh, up to 3, or 0 to skip filtering
+};
+
+/**
+ * @brief The outputs of a background estimation.
+ */
+template <typename T>
+struct BackgroundMaps {
+  Image<T, 2> background; ///< The full-resolution background
+  Image<T, 2> rms; ///< The full-resolution background RMS
+  Image<T, 2> subtracted; ///< The input image minus the background
+  Image<T, 2> mesh; ///< The filtered background of each cell
+  Image<T, 2> mesh_rms; ///< The filtered background RMS of each cell
+};
+
+namespace Impl {
+
+/**
+ * @brief The maximum radius of the mesh median filter.
+ */
+constexpr int background_filter_max_radius = 3;
+
+/**
+ * @brief Compute the sigma-clipped median and RMS of each cell, with one team per cell.
+ *
+ * The team copies the finite values of its cell to scratch memory.
+ * At each iteration, the median is computed by a single thread,
+ * the squared deviations are reduced by the whole team,
+ * and the values farther than `nsigma` RMS from the median are removed by a single thread.
+ * Cells without finite values get NaNs.
+ */
+template <typename TSpace, typename TIn, typename T>
+void clip_cells(
+    const TIn& in,
+    const Image<T, 2>& mesh,
+    const Image<T, 2>& mesh_rms,
+    const Position<2>& cell_shape,
+    const BackgroundParameters& parameters)
+{
+  using Policy = Kokkos::TeamPolicy<TSpace>;
+  using Member = typename Policy::member_type;
+  using Scratch = Kokkos::View<T*, typename TSpace::scratch_memory_space, Kokkos::MemoryUnmanaged>;
+
+  const Index width = in.extent(0);
+  const Index height = in.extent(1);
+  const Index cell_width = cell_shape[0];
+  const Index cell_height = cell_shape[1];
+  const Index mesh_width = mesh.extent(0);
+  const Index cell_size = cell_width * cell_height;
+  const T nsigma = parameters.nsigma;
+  const int iterations = parameters.iterations;
+  const auto bytes = Scratch::shmem_size(cell_size);
+  const int level = bytes <= 32768 ? 0 : 1;
+
+  Kokkos::parallel_for(
+      "estimate_background() cells",
+      Policy(mesh.size(), Kokkos::AUTO).set_scratch_size(level, Kokkos::PerTeam(bytes)),
+      KOKKOS_LAMBDA(const Member& team) {
+        const Index u = team.league_rank() % mesh_width;
+        const Index v = team.league_rank() / mesh_width;
+        const Index x0 = u * cell_width;
+        const Index y0 = v * cell_height;
+        const Index w = Kokkos::min(cell_width, width - x0);
+        const Index h = Kokkos::min(cell_height, height - y0);
+        Scratch values(team.team_scratch(level), cell_size);
+
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, w * h), [&](Index k) {
+          values(k) = in(x0 + k % w, y0 + k / w);
+        });
+        team.team_barrier();
+
+        Index size = 0;
+        Kokkos::single(
+            Kokkos::PerTeam(team),
+            [&](Index& count) {
+              count = 0;
+              for (Index k = 0; k < w * h; ++k) {
+                if (Kokkos::isfinite(values(k))) {
+                  values(count++) = values(k);
+                }
+              }
+            },
+            size);
+
+        T center = Kokkos::Experimental::quiet_NaN_v<T>;
+        T rms = Kokkos::Experimental::quiet_NaN_v<T>;
+        for (int it = 0; size > 0; ++it) {
+          Kokkos::single(
+              Kokkos::PerTeam(team),
+              [&](T& median_value) {
+                Prefix<Scratch> kept {values, static_cast<std::size_t>(size)};
+                median_value = median(kept);
+              },
+              center);
+          T sum2 = 0;
+          Kokkos::parallel_reduce(
+              Kokkos::TeamThreadRange(team, size),
+              [&](Index k, T& partial) {
+                const auto diff = values(k) - center;
+                partial += diff * diff;
+              },
+              sum2);
+          rms = Kokkos::sqrt(sum2 / size);
+          if (it == iterations) {
+            break;
+          }
+          const auto bound = nsigma * rms;
+          Index count = 0;
+          Kokkos::parallel_reduce(
+              Kokkos::TeamThreadRange(team, size),
+              [&](Index k, Index& partial) {
+                partial += Kokkos::abs(values(k) - center) <= bound;
+              },
+              count);
+          if (count == size || count == 0) {
+            break;
+          }
+          team.team_barrier();
+          Kokkos::single(Kokkos::PerTeam(team), [&]() {
+            Index j = 0;
+            for (Index k = 0; k < size; ++k) {
+              if (Kokkos::abs(values(k) - center) <= bound) {
+                values(j++) = values(k);
+              }
+            }
+          });
+          team.team_barrier();
+          size = count;
+        }
+
+        Kokkos::single(Kokkos::PerTeam(team), [&]() {
+          mesh(u, v) = center;
+          mesh_rms(u, v) = rms;
+        });
+      });
+}
+
+/**
+ * @brief Median-filter a mesh, with a window which is cropped at the borders.
+ */
+template <typename TSpace, typename T>
+Image<T, 2> filter_mesh(const Image<T, 2>& in, int radius)
+{
+  Image<T, 2> out(compose_label("filter_mesh", in), in.shape());
+  const Index width = in.extent(0);
+  const Index height = in.extent(1);
+  for_each<TSpace>(
+      "estimate_background() filter",
+      out.domain(),
+      KOKKOS_LAMBDA(Index u, Index v) {
+        constexpr int diameter = 2 * background_filter_max_radius + 1;
+        Kokkos::Array<T, diameter * diameter> window;
+        std::size_t size = 0;
+        for (Index j = Kokkos::max(v - radius, Index(0)); j <= Kokkos::min(v + radius, height - 1); ++j) {
+          for (Index i = Kokkos::max(u - radius, Index(0)); i <= Kokkos::min(u + radius, width - 1); ++i) {
+            const auto value = in(i, j);
+            if (Kokkos::isfinite(value)) {
+              window[size++] = value;
+            }
+          }
+        }
+        Prefix<decltype(window)> kept {window, size};
+        out(u, v) = size ? median(kept) : Kokkos::Experimental::quiet_NaN_v<T>;
+      });
+  return out;
+}
+
+/**
+ * @brief The Catmull-Rom cubic convolution weights of the 4 nearest nodes at fractional position `t`.
+ */
+template <typename T>
+KOKKOS_INLINE_FUNCTION Kokkos::Array<T, 4> cubic_weights(T t)
+{
+  const T t2 = t * t;
+  const T t3 = t2 * t;
+  return {
+      T(-0.5) * t3 + t2 - T(0.5) * t,
+      T(1.5) * t3 - T(2.5) * t2 + T(1),
+      T(-1.5) * t3 + T(2) * t2 + T(0.5) * t,
+      T(0.5) * t3 - T(0.5) * t2};
+}
+
+} // namespace Impl
+
+/**
+ * @brief Estimate the background of an image on a mesh, and subtract it.
+ *
+ * @param in The input image
+ * @param cell_shape The cell shape, e.g. 64 x 64 pixels
+ * @param parameters The clipping and filtering parameters
+ *
+ * The processing consists in three kernels:
+ * - The image is tiled into cells, and one team per cell computes the sigma-clipped median and RMS of its values,
+ *   which are stored in team scratch memory;
+ * - The resulting coarse meshes are median-filtered;
+ * - The meshes are interpolated back to full resolution with bicubic (Catmull-Rom) interpolation,
+ *   where cell values are located at the cell centers and borders are clamped,
+ *   and the background is subtracted from the image in the same pass.
+ *
+ * Non-finite input values are ignored.
+ */
+template <typename TIn>
+auto estimate_background(const TIn& in, const Position<2>& cell_shape, const BackgroundParameters& parameters = {})
+{
+  static_assert(TIn::Rank == 2);
+  using U = std::remove_cv_t<typename TIn::element_type>;
+  using T = std::conditional_t<std::is_floating_point_v<U>, U, float>;
+  using Space = typename TIn::execution_space;
+  OutOfBounds<'[', ']'>::may_throw("filter radius", parameters.filter_radius, {0, Impl::background_filter_max_radius});
+
+  const Index width = in.extent(0);
+  const Index height = in.extent(1);
+  const Index cell_width = cell_shape[0];
+  const Index cell_height = cell_shape[1];
+  const Index mesh_width = (width + cell_width - 1) / cell_width;
+  const Index mesh_height = (height + cell_height - 1) / cell_height;
+  Image<T, 2> mesh(compose_label("mesh", in), mesh_width, mesh_height);
+  Image<T, 2> mesh_rms(compose_label("mesh_rms", in), mesh.shape());
+  Impl::clip_cells<Space>(as_readonly(in), mesh, mesh_rms, cell_shape, parameters);
+  if (parameters.filter_radius > 0) {
+    mesh = Impl::filter_mesh<Space>(mesh, parameters.filter_radius);
+    mesh_rms = Impl::filter_mesh<Space>(mesh_rms, parameters.filter_radius);
+  }
+
+  BackgroundMaps<T> out {
+      Image<T, 2>(compose_label("background", in), in.shape()),
+      Image<T, 2>(compose_label("rms", in), in.shape()),
+      Image<T, 2>(compose_label("subtracted", in), in.shape()),
+      mesh,
+      mesh_rms};
+  const auto image = as_readonly(in);
+  const auto background = out.background;
+  const auto rms = out.rms;
+  const auto subtracted = out.subtracted;
+  for_each<Space>(
+      "estimate_background() interpolate",
+      in.domain(),
+      KOKKOS_LAMBDA(Index x, Index y) {
+        const T s = (x + T(0.5)) / cell_width - T(0.5);
+        const T t = (y + T(0.5)) / cell_height - T(0.5);
+        const auto i0 = Kokkos::floor(s);
+        const auto j0 = Kokkos::floor(t);
+        const auto wx = Impl::cubic_weights<T>(s - i0);
+        const auto wy = Impl::cubic_weights<T>(t - j0);
+        T b = 0;
+        T r = 0;
+        for (int n = 0; n < 4; ++n) {
+          const auto j = Kokkos::clamp(Index(j0) - 1 + n, Index(0), mesh_height - 1);
+          for (int m = 0; m < 4; ++m) {
+            const auto i = Kokkos::clamp(Index(i0) - 1 + m, Index(0), mesh_width - 1);
+            const auto weight = wx[m] * wy[n];
+            b += weight * mesh(i, j);
+            r += weight * mesh_rms(i, j);
+          }
+        }
+        background(x, y) = b;
+        rms(x, y) = r;
+        subtracted(x, y) = image(x, y) - b;
+      });
+  return out;
+}
+
+} // namespace Linx
+
+#endif
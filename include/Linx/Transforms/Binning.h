@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_BINNING_H
+#define _LINXTRANSFORMS_BINNING_H
+
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Transforms/mixins/FilterMixin.h"
+
+#include <Kokkos_Core.hpp>
+#include <concepts>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Linx {
+
+/**
+ * @brief Binning of a value image, and optional propagation of its variance.
+ *
+ * The offsets of the block elements relative to the block front are computed once,
+ * and shared by the value and variance images when both are binned.
+ */
+template <typename TIn, typename TVariance = void>
+class Binning : public MorphologyFilterMixin<TIn, Binning<TIn, TVariance>> {
+public:
+
+  static constexpr int Rank = TIn::Rank;
+  static constexpr bool Propagate = not std::is_void_v<TVariance>;
+  using element_type = std::remove_cv_t<typename TIn::element_type>;
+  using Output = Image<element_type, Rank>;
+  using VarianceInput = std::conditional_t<Propagate, TVariance, TIn>; ///< The variance parameter type
+
+  /**
+   * @brief Constructor.
+   */
+  Binning(const Position<Rank>& factors, const TIn& in, const Output& out) :
+      MorphologyFilterMixin<TIn, Binning>(Box<Rank>(Position<Rank>(factors.size()), factors), in),
+      m_factors(), m_variance(), m_out(out), m_out_variance()
+  {
+    for (int i = 0; i < Rank; ++i) {
+      m_factors[i] = factors[i];
+    }
+    this->instrument(label());
+  }
+
+  /**
+   * @brief Constructor with variance propagation.
+   */
+  Binning(
+      const Position<Rank>& factors,
+      const TIn& in,
+      const VarianceInput& variance,
+      const Output& out,
+      const Output& out_variance)
+  requires(Propagate)
+      : Binning(factors, in, out)
+  {
+    Impl::check_same_layout("variance", in, variance);
+    m_variance = as_readonly(variance);
+    m_out_variance = out_variance;
+  }
+
+  std::string label() const
+  {
+    return "Binning";
+  }
+
+  /**
+   * @brief Bin the block which corresponds to an output position.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(const std::integral auto&... is) const
+  {
+    bin(std::make_index_sequence<sizeof...(is)>(), is...);
+  }
+
+private:
+
+  template <std::size_t... Ks>
+  KOKKOS_INLINE_FUNCTION void bin(std::index_sequence<Ks...>, const std::integral auto&... is) const
+  {
+    const auto in_ptr = &this->m_in((is * m_factors[Ks])...);
+    const auto variance_ptr = [&]() {
+      if constexpr (Propagate) {
+        return &m_variance((is * m_factors[Ks])...);
+      } else {
+        return nullptr;
+      }
+    }();
+    element_type value {};
+    element_type variance {};
+    for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
+      const auto offset = this->m_offsets[i];
+      value += in_ptr[offset];
+      if constexpr (Propagate) {
+        variance += variance_ptr[offset];
+      }
+    }
+    m_out(is...) = value;
+    if constexpr (Propagate) {
+      m_out_variance(is...) = variance;
+    }
+    this->m_counters.add(Counter::Taps, (1 + Propagate) * this->m_offsets.size());
+    this->m_counters.count_element();
+  }
+
+  Kokkos::Array<Index, Rank> m_factors; ///< The binning factors
+  Impl::OptionalInput<TVariance> m_variance; ///< The input variance, if any
+  Output m_out; ///< The output values
+  std::conditional_t<Propagate, Output, Forward> m_out_variance; ///< The output variance, if any
+};
+
+namespace Impl {
+
+/**
+ * @brief The shape of a binned image, where incomplete blocks are dropped.
+ */
+template <typename TIn>
+Position<TIn::Rank> binned_shape(const TIn& in, const Position<TIn::Rank>& factors)
+{
+  SizeMismatch::may_throw("binning factors", in.rank(), factors);
+  Position<TIn::Rank> shape(factors.size());
+  for (int i = 0; i < in.rank(); ++i) {
+    OutOfBounds<'[', ']'>::may_throw("binning factor", factors[i], {Index(1), Index(in.extent(i))});
+    shape[i] = in.extent(i) / factors[i];
+  }
+  return shape;
+}
+
+} // namespace Impl
+
+/**
+ * @brief Sum the values of an image over blocks of given shape.
+ *
+ * @param in The input image
+ * @param factors The block shape
+ *
+ * The output extent along axis `i` is `in.extent(i) / factors[i]`, i.e. incomplete blocks are dropped.
+ * Summing instead of averaging preserves the flux.
+ */
+template <typename TIn>
+requires(TIn::Rank >= 0)
+auto bin(const TIn& in, const Position<TIn::Rank>& factors)
+{
+  using Filter = Binning<TIn>;
+  typename Filter::Output out(compose_label("bin", in), Impl::binned_shape(in, factors));
+  for_each<typename TIn::execution_space>("bin()", out.domain(), Filter(factors, in, out));
+  return out;
+}
+
+/**
+ * @brief Sum the values of an image over blocks of given shape, and propagate the variance, in a single pass.
+ *
+ * @param in The input values
+ * @param variance The input variance, of same shape and layout as `in`
+ * @param factors The block shape
+ *
+ * The output variance is the sum of the input variance over the blocks,
+ * i.e. the input values are assumed to be uncorrelated.
+ *
+ * @see `bin()`
+ */
+template <typename TIn, typename TVariance>
+requires(TIn::Rank >= 0)
+auto bin(const TIn& in, const TVariance& variance, const Position<TIn::Rank>& factors)
+{
+  using Filter = Binning<TIn, TVariance>;
+  using T = typename Filter::element_type;
+  constexpr auto N = TIn::Rank;
+  const auto shape = Impl::binned_shape(in, factors);
+  WithVariance<T, N> out {
+      Image<T, N>(compose_label("bin", in), shape),
+      Image<T, N>(compose_label("bin", variance), shape)};
+  for_each<typename TIn::execution_space>(
+      "bin()",
+      out.value.domain(),
+      Filter(factors, in, variance, out.value, out.variance));
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,240 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_CALIBRATION_H
+#define _LINXTRANSFORMS_CALIBRATION_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Functional.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+
+namespace Linx {
+
+/**
+ * @brief The flags of calibrated pixels, which are bits to be combined.
+ */
+struct CalibrationFlag {
+  static constexpr std::uint8_t Valid = 0; ///< No issue
+  static constexpr std::uint8_t Bad = 1; ///< Bad pixel according to the mask
+  static constexpr std::uint8_t Saturated = 2; ///< Raw value at or above the saturation level
+  static constexpr std::uint8_t InvalidFlat = 4; ///< Non-positive or non-finite flat value
+};
+
+/**
+ * @brief The scalar parameters of a calibration.
+ */
+struct CalibrationParameters {
+  double exposure = 1; ///< The exposure time, in the time unit of the dark current
+  double gain = 1; ///< The gain, in electrons per ADU
+  double read_noise = 0; ///< The read noise, in ADU
+  double saturation = std::numeric_limits<double>::infinity(); ///< The raw saturation level, in ADU
+};
+
+/**
+ * @brief The outputs of a calibration.
+ */
+template <typename T, int N>
+struct Calibrated {
+  Image<T, N> value; ///< The calibrated values
+  Image<T, N> variance; ///< The variance of the calibrated values
+  Image<std::uint8_t, N> flags; ///< The combinations of `CalibrationFlag` bits
+};
+
+namespace Impl {
+
+/**
+ * @brief Fused calibration functor.
+ *
+ * The variances of the calibration frames are constant zeros unless they are propagated.
+ */
+template <
+    typename TRaw,
+    typename TBias,
+    typename TDark,
+    typename TFlat,
+    typename TBiasVariance,
+    typename TDarkVariance,
+    typename TFlatVariance,
+    typename TMask,
+    typename T,
+    int N>
+struct Calibrator {
+  TRaw m_raw; ///< The raw frame
+  TBias m_bias; ///< The bias frame
+  TDark m_dark; ///< The dark current frame
+  TFlat m_flat; ///< The normalized flat field
+  TBiasVariance m_bias_variance; ///< The variance of the bias frame
+  TDarkVariance m_dark_variance; ///< The variance of the dark current frame
+  TFlatVariance m_flat_variance; ///< The variance of the normalized flat field
+  TMask m_mask; ///< The bad pixel mask
+  Image<T, N> m_value; ///< The calibrated frame
+  Image<T, N> m_variance; ///< The variance frame
+  Image<std::uint8_t, N> m_flags; ///< The flag frame
+  T m_exposure; ///< The exposure time
+  T m_inv_gain; ///< The inverse gain
+  T m_read_variance; ///< The squared read noise
+  T m_saturation; ///< The saturation level
+
+  /**
+   * @brief Calibrate a pixel.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(std::integral auto... is) const
+  {
+    const T raw = m_raw(is...);
+    const T flat = m_flat(is...);
+    const T signal = raw - m_bias(is...);
+    const T electrons = signal - m_dark(is...) * m_exposure;
+    std::uint8_t flags = CalibrationFlag::Valid;
+    if (m_mask(is...)) {
+      flags |= CalibrationFlag::Bad;
+    }
+    if (raw >= m_saturation) {
+      flags |= CalibrationFlag::Saturated;
+    }
+    if (not(flat > 0 && Kokkos::isfinite(flat))) {
+      flags |= CalibrationFlag::InvalidFlat;
+    }
+    if (flags & (CalibrationFlag::Bad | CalibrationFlag::InvalidFlat)) {
+      m_value(is...) = Kokkos::Experimental::quiet_NaN_v<T>;
+      m_variance(is...) = Kokkos::Experimental::infinity_v<T>;
+    } else {
+      const T value = electrons / flat;
+      const T frame_variance = m_bias_variance(is...) + m_dark_variance(is...) * m_exposure * m_exposure +
+          value * value * m_flat_variance(is...);
+      m_value(is...) = value;
+      m_variance(is...) = (Kokkos::max(signal, T(0)) * m_inv_gain + m_read_variance + frame_variance) / (flat * flat);
+    }
+    m_flags(is...) = flags;
+  }
+};
+
+/**
+ * @brief Run the calibration functor.
+ */
+template <typename T, typename TRaw, typename... TFrames>
+Calibrated<T, TRaw::Rank>
+calibrate_impl(const TRaw& raw, const CalibrationParameters& parameters, const TFrames&... frames)
+{
+  constexpr auto N = TRaw::Rank;
+  using Space = typename TRaw::execution_space;
+  Calibrated<T, N> out {
+      Image<T, N>(compose_label("calibrate", raw), raw.shape()),
+      Image<T, N>(compose_label("variance", raw), raw.shape()),
+      Image<std::uint8_t, N>(compose_label("flags", raw), raw.shape())};
+  using Functor = Calibrator<std::decay_t<decltype(as_readonly(raw))>, TFrames..., T, N>;
+  for_each<Space>(
+      "calibrate()",
+      out.value.domain(),
+      Functor {
+          as_readonly(raw),
+          frames...,
+          out.value,
+          out.variance,
+          out.flags,
+          static_cast<T>(parameters.exposure),
+          static_cast<T>(1 / parameters.gain),
+          static_cast<T>(parameters.read_noise * parameters.read_noise),
+          static_cast<T>(parameters.saturation)});
+  return out;
+}
+
+} // namespace Impl
+
+/**
+ * @brief Calibrate a raw frame in a single fused pass.
+ *
+ * @tparam T The floating point type of the outputs
+ * @param raw The raw frame, in ADU
+ * @param bias The bias frame, in ADU
+ * @param dark The dark current frame, in ADU per time unit
+ * @param flat The normalized flat field
+ * @param mask The bad pixel mask, where nonzero values denote bad pixels
+ * @param parameters The exposure time, gain, read noise and saturation level
+ *
+ * Each input is read once, and the three outputs are written in the same kernel:
+ * - The calibrated value is `(raw - bias - dark * exposure) / flat`;
+ * - The variance is `(max(raw - bias, 0) / gain + read_noise^2) / flat^2`,
+ *   i.e. the Poisson noise of the bias-subtracted signal plus the read noise, propagated through the flat;
+ * - The flags are a combination of `CalibrationFlag` bits.
+ *
+ * Bad pixels and pixels with an invalid flat get a NaN value and an infinite variance.
+ * Saturated pixels are flagged, but still calibrated.
+ */
+template <typename T = float, typename TRaw, typename TBias, typename TDark, typename TFlat, typename TMask>
+Calibrated<T, TRaw::Rank> calibrate(
+    const TRaw& raw,
+    const TBias& bias,
+    const TDark& dark,
+    const TFlat& flat,
+    const TMask& mask,
+    const CalibrationParameters& parameters = {})
+{
+  SizeMismatch::may_throw("calibration frame", raw.size(), bias, dark, flat, mask);
+  const Constant<T> zero(0);
+  return Impl::calibrate_impl<T>(
+      raw,
+      parameters,
+      as_readonly(bias),
+      as_readonly(dark),
+      as_readonly(flat),
+      zero,
+      zero,
+      zero,
+      as_readonly(mask));
+}
+
+/**
+ * @brief Calibrate a raw frame and propagate the variances of the calibration frames, in a single fused pass.
+ *
+ * @param bias The bias frame and its variance
+ * @param dark The dark current frame and its variance
+ * @param flat The normalized flat field and its variance
+ *
+ * The variance of the calibrated value is that of `calibrate()`, plus the contributions of the calibration frames:
+ * `(var(bias) + var(dark) * exposure^2 + value^2 * var(flat)) / flat^2`,
+ * where the frames are assumed to be uncorrelated.
+ *
+ * @copydetails calibrate()
+ */
+template <typename T = float, typename TRaw, typename TB, typename TD, typename TF, int N, typename TMask>
+Calibrated<T, TRaw::Rank> calibrate(
+    const TRaw& raw,
+    const WithVariance<TB, N>& bias,
+    const WithVariance<TD, N>& dark,
+    const WithVariance<TF, N>& flat,
+    const TMask& mask,
+    const CalibrationParameters& parameters = {})
+{
+  SizeMismatch::may_throw(
+      "calibration frame",
+      raw.size(),
+      bias.value,
+      bias.variance,
+      dark.value,
+      dark.variance,
+      flat.value,
+      flat.variance,
+      mask);
+  return Impl::calibrate_impl<T>(
+      raw,
+      parameters,
+      as_readonly(bias.value),
+      as_readonly(dark.value),
+      as_readonly(flat.value),
+      as_readonly(bias.variance),
+      as_readonly(dark.variance),
+      as_readonly(flat.variance),
+      as_readonly(mask));
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,185 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_COMPLEX_H
+#define _LINXTRANSFORMS_COMPLEX_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Base/mixins/Range.h" // is_contiguous
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @brief Test whether an image is a contiguous image of complex values.
+ */
+template <typename TIn>
+constexpr bool is_contiguous_complex()
+{
+  return is_complex<std::remove_cv_t<typename TIn::element_type>>() && is_contiguous<typename TIn::Container>();
+}
+
+namespace Impl {
+
+/**
+ * @brief The scalar type of a complex image.
+ */
+template <typename TIn>
+using ComplexScalar = typename std::remove_cv_t<typename TIn::element_type>::value_type;
+
+/**
+ * @brief View the data of a contiguous complex image as interleaved real and imaginary parts.
+ *
+ * Both `std::complex` and `Kokkos::complex` are guaranteed to be layout-compatible with an array of two scalars.
+ */
+template <typename TIn>
+auto interleaved(const TIn& in)
+{
+  using R = ComplexScalar<TIn>;
+  using U = std::conditional_t<std::is_const_v<typename TIn::element_type>, const R, R>;
+  return reinterpret_cast<U*>(in.data());
+}
+
+/**
+ * @brief Run a kernel over the elements of a contiguous image.
+ */
+template <typename TIn, typename TFunc>
+void for_each_element(const std::string& label, const TIn& in, const TFunc& func)
+{
+  using Space = typename TIn::execution_space;
+  Kokkos::parallel_for(label, Kokkos::RangePolicy<Space>(0, in.size()), func);
+}
+
+} // namespace Impl
+
+/**
+ * @brief Multiply two contiguous complex images element-wise.
+ *
+ * The kernels of this file work on the interleaved scalar parts instead of complex values,
+ * which spares the special value handling of complex operators and lets compilers vectorize the loops.
+ */
+template <typename TLhs, typename TRhs>
+requires(is_contiguous_complex<TLhs>() && is_contiguous_complex<TRhs>())
+auto complex_multiply(const TLhs& lhs, const TRhs& rhs)
+{
+  SizeMismatch::may_throw("rhs", rhs.size(), lhs);
+  using T = std::remove_cv_t<typename TLhs::element_type>;
+  Image<T, TLhs::Rank> out(compose_label("complex_multiply", lhs, rhs), lhs.shape());
+  auto a = Impl::interleaved(lhs);
+  auto b = Impl::interleaved(rhs);
+  auto c = Impl::interleaved(out);
+  Impl::for_each_element(
+      "complex_multiply()",
+      out,
+      KOKKOS_LAMBDA(Index i) {
+        const auto re = a[2 * i] * b[2 * i] - a[2 * i + 1] * b[2 * i + 1];
+        const auto im = a[2 * i] * b[2 * i + 1] + a[2 * i + 1] * b[2 * i];
+        c[2 * i] = re;
+        c[2 * i + 1] = im;
+      });
+  return out;
+}
+
+/**
+ * @brief Multiply a contiguous complex image by the conjugate of another, element-wise.
+ *
+ * This is typically the cross-power spectrum of two Fourier transforms.
+ *
+ * @copydetails complex_multiply()
+ */
+template <typename TLhs, typename TRhs>
+requires(is_contiguous_complex<TLhs>() && is_contiguous_complex<TRhs>())
+auto conj_multiply(const TLhs& lhs, const TRhs& rhs)
+{
+  SizeMismatch::may_throw("rhs", rhs.size(), lhs);
+  using T = std::remove_cv_t<typename TLhs::element_type>;
+  Image<T, TLhs::Rank> out(compose_label("conj_multiply", lhs, rhs), lhs.shape());
+  auto a = Impl::interleaved(lhs);
+  auto b = Impl::interleaved(rhs);
+  auto c = Impl::interleaved(out);
+  Impl::for_each_element(
+      "conj_multiply()",
+      out,
+      KOKKOS_LAMBDA(Index i) {
+        const auto re = a[2 * i] * b[2 * i] + a[2 * i + 1] * b[2 * i + 1];
+        const auto im = a[2 * i + 1] * b[2 * i] - a[2 * i] * b[2 * i + 1];
+        c[2 * i] = re;
+        c[2 * i + 1] = im;
+      });
+  return out;
+}
+
+/**
+ * @brief Compute the magnitude of a contiguous complex image.
+ *
+ * As opposed to `std::abs()`, intermediate values are not rescaled,
+ * such that the result overflows if a squared part overflows.
+ */
+template <typename TIn>
+requires(is_contiguous_complex<TIn>())
+auto magnitude(const TIn& in)
+{
+  using R = Impl::ComplexScalar<TIn>;
+  Image<R, TIn::Rank> out(compose_label("magnitude", in), in.shape());
+  auto a = Impl::interleaved(in);
+  auto b = out.data();
+  Impl::for_each_element(
+      "magnitude()",
+      out,
+      KOKKOS_LAMBDA(Index i) { b[i] = Kokkos::sqrt(a[2 * i] * a[2 * i] + a[2 * i + 1] * a[2 * i + 1]); });
+  return out;
+}
+
+/**
+ * @brief Compute the phase of a contiguous complex image, in radians in [-pi, pi].
+ */
+template <typename TIn>
+requires(is_contiguous_complex<TIn>())
+auto phase(const TIn& in)
+{
+  using R = Impl::ComplexScalar<TIn>;
+  Image<R, TIn::Rank> out(compose_label("phase", in), in.shape());
+  auto a = Impl::interleaved(in);
+  auto b = out.data();
+  Impl::for_each_element(
+      "phase()",
+      out,
+      KOKKOS_LAMBDA(Index i) { b[i] = Kokkos::atan2(a[2 * i + 1], a[2 * i]); });
+  return out;
+}
+
+/**
+ * @brief Make a complex image from magnitude and phase images.
+ *
+ * @tparam T The complex output type, `Kokkos::complex` of the input scalar type by default
+ */
+template <typename T = void, typename TMag, typename TPhase>
+requires(is_contiguous<typename TMag::Container>() && is_contiguous<typename TPhase::Container>())
+auto polar(const TMag& magnitude, const TPhase& phase)
+{
+  SizeMismatch::may_throw("phase", phase.size(), magnitude);
+  using R = std::remove_cv_t<typename TMag::element_type>;
+  using U = std::conditional_t<std::is_void_v<T>, Kokkos::complex<R>, T>;
+  Image<U, TMag::Rank> out(compose_label("polar", magnitude, phase), magnitude.shape());
+  auto m = magnitude.data();
+  auto p = phase.data();
+  auto c = Impl::interleaved(out);
+  Impl::for_each_element(
+      "polar()",
+      out,
+      KOKKOS_LAMBDA(Index i) {
+        c[2 * i] = m[i] * Kokkos::cos(p[i]);
+        c[2 * i + 1] = m[i] * Kokkos::sin(p[i]);
+      });
+  return out;
+}
+
+} // namespace Linx
+
+#endif
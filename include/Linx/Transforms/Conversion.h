@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_CONVERSION_H
+#define _LINXTRANSFORMS_CONVERSION_H
+
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <concepts>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @brief Rounding mode of conversions to integral types.
+ */
+enum class Rounding : char {
+  Nearest = 'n', ///< To nearest, halfway cases away from zero
+  Floor = 'f', ///< Toward negative infinity
+  Ceil = 'c', ///< Toward positive infinity
+  Truncate = 't' ///< Toward zero
+};
+
+namespace Impl {
+
+/**
+ * @brief The floating point type in which a conversion from `T` to `U` is computed.
+ *
+ * This is `float` unless one of the types is `double` or an integral type which `float` cannot represent exactly.
+ */
+template <typename T, typename U>
+using ConversionFloat = std::conditional_t<
+    (sizeof(ComputeType<T>) > sizeof(float) || (std::is_integral_v<T> && sizeof(T) > 2) ||
+     sizeof(ComputeType<U>) > sizeof(float) || (std::is_integral_v<U> && sizeof(U) > 2)),
+    double,
+    float>;
+
+/**
+ * @brief The largest value of type `TFloat` which does not exceed the maximum value of `U`.
+ *
+ * The maximum of a wide integral type, e.g. `2^63 - 1`, is rounded up by the conversion to floating point,
+ * such that casting it back would overflow.
+ * In this case, the largest representable value below `2^d`, i.e. `2^d - 2^(d - p)`, is returned instead,
+ * where `d` and `p` are the numbers of digits of `U` and `TFloat`.
+ */
+template <typename U, typename TFloat>
+constexpr TFloat saturation_max()
+{
+  if constexpr (std::is_integral_v<U> && std::numeric_limits<U>::digits > std::numeric_limits<TFloat>::digits) {
+    constexpr int d = std::numeric_limits<U>::digits;
+    constexpr int p = std::numeric_limits<TFloat>::digits;
+    return static_cast<TFloat>((U(1) << (d - 1)) - (U(1) << (d - p - 1))) * 2; // Avoid computing 2^d
+  } else {
+    return static_cast<TFloat>(Limits<U>::Bounds::max());
+  }
+}
+
+/**
+ * @brief Affine conversion functor, followed by optional rounding and saturation.
+ *
+ * The rounding and saturation are compile-time parameters,
+ * such that the kernel is branchless and can be vectorized:
+ * saturation is a pair of min/max operations before the cast.
+ * For integral `U`, `fmin()` and `fmax()` map NaNs to the lowest value, which makes the cast well defined;
+ * for floating point `U`, comparisons are used instead, such that NaNs are kept.
+ */
+template <typename U, typename TFloat, Rounding TRounding, bool Saturate>
+struct Converter {
+  TFloat m_scale; ///< The scaling factor
+  TFloat m_offset; ///< The offset, applied after scaling
+
+  /**
+   * @brief Convert a value.
+   */
+  KOKKOS_INLINE_FUNCTION U operator()(const auto& in) const
+  {
+    TFloat value = static_cast<TFloat>(static_cast<ComputeType<std::decay_t<decltype(in)>>>(in)) * m_scale + m_offset;
+    if constexpr (std::is_integral_v<U>) {
+      if constexpr (TRounding == Rounding::Nearest) {
+        value = Kokkos::round(value);
+      } else if constexpr (TRounding == Rounding::Floor) {
+        value = Kokkos::floor(value);
+      } else if constexpr (TRounding == Rounding::Ceil) {
+        value = Kokkos::ceil(value);
+      } // Truncation is performed by the cast
+    }
+    if constexpr (Saturate) {
+      constexpr auto lowest = static_cast<TFloat>(Limits<U>::Bounds::lowest()); // -2^d or 0, which is exact
+      constexpr auto highest = saturation_max<U, TFloat>();
+      if constexpr (std::is_integral_v<U>) {
+        value = Kokkos::fmin(Kokkos::fmax(value, lowest), highest);
+      } else {
+        value = value < lowest ? lowest : (value > highest ? highest : value);
+      }
+    }
+    return static_cast<U>(static_cast<ComputeType<U>>(value));
+  }
+};
+
+/**
+ * @brief Apply a conversion functor, with compile-time rounding and saturation.
+ */
+template <typename U, Rounding TRounding, bool Saturate, typename TIn, typename TFloat>
+Image<U, TIn::Rank> convert_impl(const std::string& label, const TIn& in, TFloat scale, TFloat offset)
+{
+  Image<U, TIn::Rank> out(label, in.shape());
+  out.generate("convert_to()", Converter<U, TFloat, TRounding, Saturate> {scale, offset}, in);
+  return out;
+}
+
+/**
+ * @brief Dispatch the rounding and saturation modes.
+ */
+template <typename U, typename TIn, typename TFloat>
+Image<U, TIn::Rank>
+convert_dispatch(const std::string& label, const TIn& in, TFloat scale, TFloat offset, Rounding rounding, bool saturate)
+{
+#define LINX_CASE_ROUNDING(mode) \
+  case Rounding::mode: \
+    return saturate ? convert_impl<U, Rounding::mode, true>(label, in, scale, offset) : \
+                      convert_impl<U, Rounding::mode, false>(label, in, scale, offset);
+
+  switch (rounding) {
+    LINX_CASE_ROUNDING(Nearest)
+    LINX_CASE_ROUNDING(Floor)
+    LINX_CASE_ROUNDING(Ceil)
+    default:
+      LINX_CASE_ROUNDING(Truncate)
+  }
+
+#undef LINX_CASE_ROUNDING
+}
+
+} // namespace Impl
+
+/**
+ * @brief Convert an image to another value type with an affine transform, in a single pass.
+ *
+ * @tparam U The output value type
+ * @param in The input image
+ * @param scale The scaling factor
+ * @param offset The offset, applied after scaling
+ * @param rounding The rounding mode if `U` is integral
+ * @param saturate Whether to clamp the values to the range of `U` instead of overflowing
+ *
+ * Each output element is `round(in * scale + offset)`,
+ * where the affine transform is computed in `float`, or in `double` if `float` is not wide enough.
+ * With saturation, NaNs are mapped to the lowest value of `U` if `U` is integral, and are kept otherwise.
+ *
+ * \code
+ * auto electrons = convert_to<float>(raw, gain, -bias * gain);
+ * auto quantized = convert_to<std::int16_t>(result, 1. / step, 0., Rounding::Nearest);
+ * \endcode
+ *
+ * @see `convert_back_to()`
+ */
+template <typename U, typename TIn>
+Image<U, TIn::Rank> convert_to(
+    const TIn& in,
+    double scale = 1,
+    double offset = 0,
+    Rounding rounding = Rounding::Nearest,
+    bool saturate = true)
+{
+  using F = Impl::ConversionFloat<typename TIn::element_type, U>;
+  return Impl::convert_dispatch<U>(
+      compose_label("convert_to", in),
+      as_readonly(in),
+      static_cast<F>(scale),
+      static_cast<F>(offset),
+      rounding,
+      saturate);
+}
+
+/**
+ * @brief Apply the inverse transform of `convert_to()`.
+ *
+ * Each output element is `round((in - offset) / scale)`, such that, for example:
+ *
+ * \code
+ * auto raw = convert_back_to<std::uint16_t>(convert_to<float>(raw, gain, offset), gain, offset);
+ * \endcode
+ *
+ * recovers the raw values.
+ *
+ * @see `convert_to()`
+ */
+template <typename U, typename TIn>
+Image<U, TIn::Rank> convert_back_to(
+    const TIn& in,
+    double scale = 1,
+    double offset = 0,
+    Rounding rounding = Rounding::Nearest,
+    bool saturate = true)
+{
+  using F = Impl::ConversionFloat<typename TIn::element_type, U>;
+  return Impl::convert_dispatch<U>(
+      compose_label("convert_back_to", in),
+      as_readonly(in),
+      static_cast<F>(1 / scale),
+      static_cast<F>(-offset / scale),
+      rounding,
+      saturate);
+}
+
+} // namespace Linx
+
+#endif
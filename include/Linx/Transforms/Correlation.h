@@ -5,6 +5,7 @@
 #ifndef _LINXTRANSFORMS_CORRELATION_H
 #define _LINXTRANSFORMS_CORRELATION_H
 
+#include "Linx/Base/Types.h"
 #include "Linx/Data/Image.h"
 #include "Linx/Data/Sequence.h"
 #include "Linx/Transforms/mixins/FilterMixin.h"
@@ -12,6 +13,7 @@
 #include <Kokkos_StdAlgorithms.hpp>
 #include <concepts>
 #include <string>
+#include <type_traits>
 
 namespace Linx {
 
@@ -22,7 +24,10 @@ public:
   using value_type = typename TKernel::value_type;
   using element_type = typename TKernel::value_type;
 
-  Correlation(const TKernel& kernel, const TIn& in) : WeightedFilterMixin<TKernel, TIn, Correlation>(kernel, in) {}
+  Correlation(const TKernel& kernel, const TIn& in) : WeightedFilterMixin<TKernel, TIn, Correlation>(kernel, in)
+  {
+    this->instrument(label());
+  }
 
   std::string label() const
   {
@@ -36,10 +41,142 @@ public:
     for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
       out += this->m_weights[i] * in_ptr[this->m_offsets[i]];
     }
+    this->m_counters.add(Counter::Taps, this->m_offsets.size());
+    this->m_counters.count_element();
     return out;
   }
 };
 
+/**
+ * @brief Correlation of a value image, and propagation of its variance.
+ *
+ * The variance is correlated with the squared weights in the same loop as the values,
+ * such that the offsets and weights are loaded once for both images.
+ * Both images must have the same layout.
+ */
+template <typename TKernel, typename TIn, typename TVariance>
+class VarianceCorrelation : public WeightedFilterMixin<TKernel, TIn, VarianceCorrelation<TKernel, TIn, TVariance>> {
+public:
+
+  using value_type = typename TKernel::value_type;
+  using element_type = typename TKernel::value_type;
+  using Output = Image<std::remove_cv_t<element_type>, TIn::Rank>;
+
+  VarianceCorrelation(
+      const TKernel& kernel,
+      const TIn& in,
+      const TVariance& variance,
+      const Output& out,
+      const Output& out_variance) :
+      WeightedFilterMixin<TKernel, TIn, VarianceCorrelation>(kernel, in),
+      m_variance(as_readonly(variance)), m_out(out), m_out_variance(out_variance)
+  {
+    Impl::check_same_layout("variance", in, variance);
+    this->instrument(label());
+  }
+
+  std::string label() const
+  {
+    return "VarianceCorrelation";
+  }
+
+  KOKKOS_INLINE_FUNCTION void operator()(const std::integral auto&... is) const
+  {
+    auto in_ptr = &this->m_in(is...);
+    auto variance_ptr = &m_variance(is...);
+    element_type value {};
+    element_type variance {};
+    for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
+      const auto offset = this->m_offsets[i];
+      const auto weight = this->m_weights[i];
+      value += weight * in_ptr[offset];
+      variance += weight * weight * variance_ptr[offset];
+    }
+    m_out(is...) = value;
+    m_out_variance(is...) = variance;
+    this->m_counters.add(Counter::Taps, 2 * this->m_offsets.size());
+    this->m_counters.count_element();
+  }
+
+private:
+
+  std::decay_t<decltype(as_readonly(std::declval<TVariance>()))> m_variance; ///< The input variance
+  Output m_out; ///< The output values
+  Output m_out_variance; ///< The output variance
+};
+
+/**
+ * @brief Normalized correlation, which skips invalid input values.
+ *
+ * Taps of NaN or infinite values, or of nonzero mask values if any, are excluded,
+ * and the weights of the remaining taps are renormalized, i.e. the output is `sum(w * x) / sum(w)` over valid taps.
+ * If no tap is valid or the sum of their weights is null, the output is NaN.
+ * The mask must have the same layout as the input.
+ */
+template <typename TKernel, typename TIn, typename TMask = void>
+class NanCorrelation : public WeightedFilterMixin<TKernel, TIn, NanCorrelation<TKernel, TIn, TMask>> {
+public:
+
+  static constexpr bool Masked = not std::is_void_v<TMask>;
+  using value_type = typename TKernel::value_type;
+  using element_type = typename TKernel::value_type;
+  using MaskInput = std::conditional_t<Masked, TMask, TIn>; ///< The mask parameter type
+
+  NanCorrelation(const TKernel& kernel, const TIn& in) :
+      WeightedFilterMixin<TKernel, TIn, NanCorrelation>(kernel, in), m_mask()
+  {
+    this->instrument(label());
+  }
+
+  NanCorrelation(const TKernel& kernel, const TIn& in, const MaskInput& mask)
+  requires(Masked)
+      : NanCorrelation(kernel, in)
+  {
+    Impl::check_same_layout("mask", in, mask);
+    m_mask = as_readonly(mask);
+  }
+
+  std::string label() const
+  {
+    return "NanCorrelation";
+  }
+
+  KOKKOS_INLINE_FUNCTION auto operator()(const std::integral auto&... is) const
+  {
+    using T = ComputeType<std::remove_cv_t<element_type>>;
+    const auto in_ptr = &this->m_in(is...);
+    const auto mask_ptr = [&]() {
+      if constexpr (Masked) {
+        return &m_mask(is...);
+      } else {
+        return nullptr;
+      }
+    }();
+    T sum {};
+    T norm {};
+    for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
+      const auto offset = this->m_offsets[i];
+      const auto value = in_ptr[offset];
+      bool valid = is_valid(value);
+      if constexpr (Masked) {
+        valid = valid && not mask_ptr[offset];
+      }
+      if (valid) {
+        const auto weight = static_cast<T>(this->m_weights[i]);
+        sum += weight * static_cast<T>(value);
+        norm += weight;
+      }
+    }
+    this->m_counters.add(Counter::Taps, this->m_offsets.size());
+    this->m_counters.count_element();
+    return norm != T {} ? static_cast<element_type>(sum / norm) : invalid_value<element_type>();
+  }
+
+private:
+
+  Impl::OptionalInput<TMask> m_mask; ///< The mask, if any
+};
+
 /**
  * @brief Correlate two data containers
  * 
@@ -68,6 +205,71 @@ auto correlate(const std::string& label, const TIn& in, const TKernel& kernel) /
   return out;
 }
 
+/**
+ * @brief Correlate an image and propagate its variance, in a single pass.
+ *
+ * @param label The output label
+ * @param in The input values
+ * @param variance The input variance, of same shape and layout as `in`
+ * @param kernel The kernel container
+ *
+ * The output variance is the correlation of the input variance with the squared kernel,
+ * i.e. the input values are assumed to be uncorrelated.
+ * The output shape is that of `correlate()`.
+ */
+template <typename TIn, typename TVariance, typename TKernel>
+auto correlate(const std::string& label, const TIn& in, const TVariance& variance, const TKernel& kernel)
+{
+  using Filter = VarianceCorrelation<TKernel, TIn, TVariance>;
+  using T = std::remove_cv_t<typename TKernel::value_type>;
+  constexpr auto N = TIn::Rank;
+  const auto shape = in.shape() - kernel.shape() + 1;
+  WithVariance<T, N> out {Image<T, N>(label, shape), Image<T, N>(label + " variance", shape)};
+  for_each<typename TIn::execution_space>(
+      "correlate()",
+      out.value.domain(),
+      Filter(kernel, in, variance, out.value, out.variance));
+  return out;
+}
+
+/**
+ * @brief Correlate an image with a kernel, skipping the invalid values.
+ *
+ * @param label The output label
+ * @param in The input container
+ * @param kernel The kernel container
+ *
+ * This is a normalized correlation, where NaNs and infinities are excluded and the weights are renormalized.
+ * The output shape is that of `correlate()`.
+ *
+ * @see `NanCorrelation`
+ */
+template <typename TIn, typename TKernel>
+auto nan_correlate(const std::string& label, const TIn& in, const TKernel& kernel)
+{
+  TKernel out(label, in.shape() - kernel.shape() + 1);
+  out.copy_from(NanCorrelation(kernel, in));
+  return out;
+}
+
+/**
+ * @brief Correlate an image with a kernel, skipping the invalid and masked values.
+ *
+ * @param label The output label
+ * @param in The input container
+ * @param mask The mask, where nonzero values denote invalid pixels, of same shape and layout as `in`
+ * @param kernel The kernel container
+ *
+ * @copydetails nan_correlate()
+ */
+template <typename TIn, typename TMask, typename TKernel>
+auto nan_correlate(const std::string& label, const TIn& in, const TMask& mask, const TKernel& kernel)
+{
+  TKernel out(label, in.shape() - kernel.shape() + 1);
+  out.copy_from(NanCorrelation<TKernel, TIn, TMask>(kernel, in, mask));
+  return out;
+}
+
 } // namespace Linx
 
 #endif
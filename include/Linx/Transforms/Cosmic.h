@@ -0,0 +1,336 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_COSMIC_H
+#define _LINXTRANSFORMS_COSMIC_H
+
+#include "Linx/Base/Algorithm.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace Linx {
+
+/**
+ * @brief The parameters of a cosmic ray detection.
+ */
+struct CosmicParameters {
+  double gain = 1; ///< The gain, in electrons per ADU
+  double read_noise = 0; ///< The read noise, in ADU
+  double sigclip = 4.5; ///< The detection threshold on the Laplacian significance
+  double sigfrac = 0.3; ///< The fraction of `sigclip` for detecting the neighbors of cosmic rays
+  double objlim = 5; ///< The minimum contrast between the Laplacian and the fine structure
+  int iterations = 4; ///< The maximum number of iterations
+  int tile = 32; ///< The tile extent, excluding the halo
+};
+
+/**
+ * @brief The outputs of a cosmic ray detection.
+ */
+template <typename T>
+struct CosmicRays {
+  Image<T, 2> cleaned; ///< The image where cosmic rays are replaced with the median of their clean neighbors
+  Image<bool, 2> mask; ///< The cosmic ray mask
+};
+
+namespace Impl {
+
+/**
+ * @brief The halo of the cosmic ray tiles, i.e. the cumulated radius of the pipeline stages.
+ *
+ * The significance needs radius 4 (Laplacian or median of 5 x 5, then median of 5 x 5),
+ * as well as the fine structure (median of 3 x 3, then median of 7 x 7);
+ * growing adds 2, and cleaning adds another 2.
+ */
+constexpr Index cosmic_halo = 8;
+
+/**
+ * @brief Reflect a coordinate which lies out of an extent of at least 2.
+ */
+KOKKOS_INLINE_FUNCTION Index reflect(Index i, Index extent)
+{
+  if (i < 0) {
+    i = -i;
+  } else if (i >= extent) {
+    i = 2 * (extent - 1) - i;
+  }
+  return Kokkos::clamp(i, Index(0), extent - 1);
+}
+
+/**
+ * @brief Compute the median of a square window of a scratch tile, which is cropped at the tile borders.
+ *
+ * If a mask is given, masked values are ignored, and `fallback` is returned if all values are masked.
+ */
+template <int Radius, typename TScratch, typename TMask = std::nullptr_t>
+KOKKOS_INLINE_FUNCTION auto
+tile_median(const TScratch& in, Index extent, Index a, Index b, const TMask& mask = nullptr, double fallback = 0)
+{
+  using T = std::remove_cv_t<typename TScratch::value_type>;
+  constexpr int diameter = 2 * Radius + 1;
+  Kokkos::Array<T, diameter * diameter> window;
+  std::size_t size = 0;
+  for (Index j = Kokkos::max(b - Radius, Index(0)); j <= Kokkos::min(b + Radius, extent - 1); ++j) {
+    for (Index i = Kokkos::max(a - Radius, Index(0)); i <= Kokkos::min(a + Radius, extent - 1); ++i) {
+      if constexpr (std::is_same_v<TMask, std::nullptr_t>) {
+        window[size++] = in(i + extent * j);
+      } else if (not mask(i + extent * j)) {
+        window[size++] = in(i + extent * j);
+      }
+    }
+  }
+  Prefix<decltype(window)> kept {window, size};
+  return size ? T(median(kept)) : T(fallback);
+}
+
+/**
+ * @brief Test whether a 3 x 3 window of a scratch mask, cropped at the tile borders, contains a set pixel.
+ */
+template <typename TMask>
+KOKKOS_INLINE_FUNCTION bool tile_any(const TMask& mask, Index extent, Index a, Index b)
+{
+  for (Index j = Kokkos::max(b - 1, Index(0)); j <= Kokkos::min(b + 1, extent - 1); ++j) {
+    for (Index i = Kokkos::max(a - 1, Index(0)); i <= Kokkos::min(a + 1, extent - 1); ++i) {
+      if (mask(i + extent * j)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief One L.A.Cosmic iteration over one tile per team.
+ *
+ * The team loads the tile and its halo into scratch memory, with reflected image borders,
+ * and runs all the stages in scratch memory, separated by team barriers.
+ * Each stage is computed over the whole extended tile, with windows cropped at the tile borders,
+ * which only alters the halo.
+ * Only the cleaned values and mask of the tile core are written to global memory,
+ * and the number of new cosmic ray pixels is reduced.
+ */
+template <typename TSpace, typename T>
+struct CosmicTile {
+  using Policy = Kokkos::TeamPolicy<TSpace>;
+  using Member = typename Policy::member_type;
+  using Scratch = Kokkos::View<T*, typename TSpace::scratch_memory_space, Kokkos::MemoryUnmanaged>;
+  using Mask = Kokkos::View<bool*, typename TSpace::scratch_memory_space, Kokkos::MemoryUnmanaged>;
+
+  Image<T, 2> m_in; ///< The input image
+  Image<bool, 2> m_prior; ///< The mask of the previous iterations
+  Image<T, 2> m_out; ///< The cleaned image
+  Image<bool, 2> m_mask; ///< The updated mask
+  T m_inv_gain; ///< The inverse gain
+  T m_read_variance; ///< The squared read noise
+  T m_sigclip; ///< The detection threshold
+  T m_siglow; ///< The neighbor detection threshold
+  T m_objlim; ///< The fine structure contrast threshold
+  Index m_tile; ///< The tile core extent
+  Index m_tiles_x; ///< The number of tiles along the first axis
+  int m_level; ///< The scratch memory level
+
+  /**
+   * @brief The number of bytes of scratch memory per team.
+   */
+  static std::size_t scratch_size(Index tile)
+  {
+    const Index extent = tile + 2 * cosmic_halo;
+    return 5 * Scratch::shmem_size(extent * extent) + 3 * Mask::shmem_size(extent * extent);
+  }
+
+  /**
+   * @brief Process a tile.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(const Member& team, Index& count) const
+  {
+    constexpr Index halo = cosmic_halo;
+    const Index width = m_in.extent(0);
+    const Index height = m_in.extent(1);
+    const Index x0 = (team.league_rank() % m_tiles_x) * m_tile;
+    const Index y0 = (team.league_rank() / m_tiles_x) * m_tile;
+    const Index w = Kokkos::min(m_tile, width - x0);
+    const Index h = Kokkos::min(m_tile, height - y0);
+    const Index e = m_tile + 2 * halo;
+    const Index size = e * e;
+
+    Scratch image(team.team_scratch(m_level), size); // Input values
+    Scratch noise(team.team_scratch(m_level), size); // Median of 5 x 5, then noise, then significance
+    Scratch laplacian(team.team_scratch(m_level), size); // Clipped Laplacian of the 2x subsampled image
+    Scratch ratio(team.team_scratch(m_level), size); // Raw significance, then fine structure
+    Scratch smooth(team.team_scratch(m_level), size); // Median of 3 x 3
+    Mask prior(team.team_scratch(m_level), size); // Mask of the previous iterations
+    Mask candidates(team.team_scratch(m_level), size); // Detections, then grown detections
+    Mask grown(team.team_scratch(m_level), size); // Detections grown once
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      const auto x = reflect(x0 - halo + k % e, width);
+      const auto y = reflect(y0 - halo + k / e, height);
+      image(k) = m_in(x, y);
+      prior(k) = m_prior(x, y);
+    });
+    team.team_barrier();
+
+    // The Laplacian of the 2x subsampled image, clipped at 0 and rebinned,
+    // is the mean of the 4 clipped half-Laplacians with one horizontal and one vertical neighbor.
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      const Index a = k % e;
+      const Index b = k / e;
+      const auto v2 = 2 * image(k);
+      const auto l = image(Kokkos::max(a - 1, Index(0)) + e * b);
+      const auto r = image(Kokkos::min(a + 1, e - 1) + e * b);
+      const auto u = image(a + e * Kokkos::max(b - 1, Index(0)));
+      const auto d = image(a + e * Kokkos::min(b + 1, e - 1));
+      laplacian(k) = (Kokkos::max(v2 - l - u, T(0)) + Kokkos::max(v2 - l - d, T(0)) + Kokkos::max(v2 - r - u, T(0)) +
+                      Kokkos::max(v2 - r - d, T(0))) /
+          4;
+      noise(k) = tile_median<2>(image, e, a, b);
+      smooth(k) = tile_median<1>(image, e, a, b);
+    });
+    team.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      const auto sigma = Kokkos::sqrt(Kokkos::max(noise(k), T(1e-5)) * m_inv_gain + m_read_variance);
+      ratio(k) = laplacian(k) / (2 * sigma);
+    });
+    team.team_barrier();
+
+    // Large structures are removed from the significance
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      noise(k) = ratio(k) - tile_median<2>(ratio, e, k % e, k / e);
+    });
+    team.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      ratio(k) = Kokkos::max(smooth(k) - tile_median<3>(smooth, e, k % e, k / e), T(0.01));
+    });
+    team.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      candidates(k) = noise(k) > m_sigclip && laplacian(k) / ratio(k) > m_objlim;
+    });
+    team.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      grown(k) = noise(k) > m_sigclip && tile_any(candidates, e, k % e, k / e);
+    });
+    team.team_barrier();
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, size), [&](Index k) {
+      candidates(k) = prior(k) || (noise(k) > m_siglow && tile_any(grown, e, k % e, k / e));
+    });
+    team.team_barrier();
+
+    Index team_count = 0;
+    Kokkos::parallel_reduce(
+        Kokkos::TeamThreadRange(team, w * h),
+        [&](Index n, Index& partial) {
+          const Index a = halo + n % w;
+          const Index b = halo + n / w;
+          const Index k = a + e * b;
+          const auto value = image(k);
+          const bool masked = candidates(k);
+          m_out(x0 + n % w, y0 + n / w) = masked ? tile_median<2>(image, e, a, b, candidates, value) : value;
+          m_mask(x0 + n % w, y0 + n / w) = masked;
+          partial += masked && not prior(k);
+        },
+        team_count);
+    Kokkos::single(Kokkos::PerTeam(team), [&]() {
+      count += team_count;
+    });
+  }
+};
+
+} // namespace Impl
+
+/**
+ * @brief Detect and clean cosmic rays with the L.A.Cosmic algorithm.
+ *
+ * @param in The input image, in ADU, with a sky level
+ * @param parameters The noise model, thresholds, maximum number of iterations and tile extent
+ *
+ * Each iteration is a single kernel which processes the image tile-wise, with one team per tile.
+ * All the stages of L.A.Cosmic are computed in team scratch memory, over the tile and its halo:
+ * - The Laplacian of the 2x subsampled image, clipped at 0 and rebinned, is computed directly at full resolution;
+ * - The significance is the Laplacian divided by twice the noise, computed from the 5 x 5 median,
+ *   minus its own 5 x 5 median;
+ * - The fine structure is the 3 x 3 median minus the 7 x 7 median of the 3 x 3 median;
+ * - Cosmic rays are the pixels where the significance exceeds `sigclip`
+ *   and the ratio of the Laplacian to the fine structure exceeds `objlim`;
+ * - Detections are grown to their 3 x 3 neighbors where the significance exceeds `sigclip`,
+ *   and then once more where it exceeds `sigfrac * sigclip`;
+ * - Detections are replaced with the median of the 5 x 5 clean neighbors.
+ *
+ * Only the cleaned image and mask are written to global memory, and then used as the inputs of the next iteration,
+ * until no new cosmic ray is detected.
+ * Image borders are reflected.
+ */
+template <typename TIn>
+auto detect_cosmic_rays(const TIn& in, const CosmicParameters& parameters = {})
+{
+  static_assert(TIn::Rank == 2);
+  using U = std::remove_cv_t<typename TIn::element_type>;
+  using T = std::conditional_t<std::is_floating_point_v<U>, U, float>;
+  using Space = typename TIn::execution_space;
+  using Tile = Impl::CosmicTile<Space, T>;
+  OutOfBounds<'[', ']'>::may_throw("tile extent", parameters.tile, {1, std::numeric_limits<int>::max()});
+
+  const Index width = in.extent(0);
+  const Index height = in.extent(1);
+  OutOfBounds<'[', ']'>::may_throw("image width", width, {Impl::cosmic_halo + 1, std::numeric_limits<Index>::max()});
+  OutOfBounds<'[', ']'>::may_throw("image height", height, {Impl::cosmic_halo + 1, std::numeric_limits<Index>::max()});
+  const Index tile = parameters.tile;
+  const Index tiles_x = (width + tile - 1) / tile;
+  const Index tiles_y = (height + tile - 1) / tile;
+  const auto bytes = Tile::scratch_size(tile);
+  const int level = bytes <= 32768 ? 0 : 1;
+
+  CosmicRays<T> out {
+      Image<T, 2>(compose_label("detect_cosmic_rays", in), in.shape()),
+      Image<bool, 2>(compose_label("mask", in), in.shape())};
+  Image<T, 2> in_buffer(compose_label("buffer", in), in.shape());
+  Image<bool, 2> prior_buffer(compose_label("buffer", in), in.shape());
+  const auto image = as_readonly(in);
+  const auto cleaned = out.cleaned;
+  for_each<Space>(
+      "detect_cosmic_rays() init",
+      in.domain(),
+      KOKKOS_LAMBDA(Index x, Index y) { cleaned(x, y) = static_cast<T>(static_cast<ComputeType<U>>(image(x, y))); });
+
+  for (int it = 0; it < parameters.iterations; ++it) {
+    std::swap(out.cleaned, in_buffer);
+    std::swap(out.mask, prior_buffer);
+    Index count = 0;
+    Kokkos::parallel_reduce(
+        "detect_cosmic_rays()",
+        typename Tile::Policy(tiles_x * tiles_y, Kokkos::AUTO).set_scratch_size(level, Kokkos::PerTeam(bytes)),
+        Tile {
+            in_buffer,
+            prior_buffer,
+            out.cleaned,
+            out.mask,
+            static_cast<T>(1 / parameters.gain),
+            static_cast<T>(parameters.read_noise * parameters.read_noise),
+            static_cast<T>(parameters.sigclip),
+            static_cast<T>(parameters.sigfrac * parameters.sigclip),
+            static_cast<T>(parameters.objlim),
+            tile,
+            tiles_x,
+            level},
+        count);
+    if (count == 0) {
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,129 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_INPAINTING_H
+#define _LINXTRANSFORMS_INPAINTING_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Image.h"
+
+#include <Kokkos_Core.hpp>
+#include <concepts>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+namespace Impl {
+
+/**
+ * @brief Inpainting functor.
+ *
+ * Valid pixels are copied, and invalid pixels are replaced with the inverse squared distance weighted mean
+ * of the valid pixels of a square window, which is cropped at the image borders.
+ */
+template <typename TIn, typename TMask, typename T>
+struct Inpainter {
+  static constexpr bool Masked = not std::is_same_v<TMask, std::nullptr_t>;
+
+  TIn m_in; ///< The input image
+  TMask m_mask; ///< The mask, if any
+  Image<T, 2> m_out; ///< The output image
+  Index m_radius; ///< The window radius
+
+  /**
+   * @brief Test whether a pixel is valid.
+   */
+  KOKKOS_INLINE_FUNCTION bool valid(Index x, Index y) const
+  {
+    if constexpr (Masked) {
+      return is_valid(m_in(x, y)) && not m_mask(x, y);
+    } else {
+      return is_valid(m_in(x, y));
+    }
+  }
+
+  /**
+   * @brief Inpaint a pixel.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(Index x, Index y) const
+  {
+    if (valid(x, y)) {
+      m_out(x, y) = static_cast<T>(m_in(x, y));
+      return;
+    }
+    const Index width = m_in.extent(0);
+    const Index height = m_in.extent(1);
+    T sum = 0;
+    T norm = 0;
+    for (Index j = Kokkos::max(y - m_radius, Index(0)); j <= Kokkos::min(y + m_radius, height - 1); ++j) {
+      for (Index i = Kokkos::max(x - m_radius, Index(0)); i <= Kokkos::min(x + m_radius, width - 1); ++i) {
+        if (valid(i, j)) {
+          const T weight = T(1) / ((i - x) * (i - x) + (j - y) * (j - y));
+          sum += weight * static_cast<T>(m_in(i, j));
+          norm += weight;
+        }
+      }
+    }
+    m_out(x, y) = norm > 0 ? sum / norm : Kokkos::Experimental::quiet_NaN_v<T>;
+  }
+};
+
+/**
+ * @brief Run the inpainting functor.
+ */
+template <typename TIn, typename TMask>
+auto inpaint_impl(const TIn& in, const TMask& mask, Index radius)
+{
+  static_assert(TIn::Rank == 2);
+  using U = std::remove_cv_t<typename TIn::element_type>;
+  using T = std::conditional_t<std::is_floating_point_v<ComputeType<U>>, ComputeType<U>, float>;
+  OutOfBounds<'[', ']'>::may_throw("inpainting radius", radius, {Index(1), std::numeric_limits<Index>::max()});
+  Image<T, 2> out(compose_label("inpaint", in), in.shape());
+  using Functor = Inpainter<std::decay_t<decltype(as_readonly(in))>, TMask, T>;
+  for_each<typename TIn::execution_space>("inpaint()", out.domain(), Functor {as_readonly(in), mask, out, radius});
+  return out;
+}
+
+} // namespace Impl
+
+/**
+ * @brief Replace the invalid pixels of an image with an interpolation of their valid neighbors, in a single pass.
+ *
+ * @param in The input image
+ * @param radius The radius of the interpolation window
+ *
+ * Valid pixels are copied, and NaNs and infinities are replaced with the mean of the valid pixels
+ * of the `(2 * radius + 1)^2` window, weighted by the inverse squared distance.
+ * The window is cropped at the image borders.
+ * Pixels without valid neighbors in the window remain NaN.
+ *
+ * The output type is the input type if it is `float` or `double`, or `float` otherwise.
+ */
+template <typename TIn>
+auto inpaint(const TIn& in, Index radius = 2)
+{
+  return Impl::inpaint_impl(in, nullptr, radius);
+}
+
+/**
+ * @brief Replace the invalid and masked pixels of an image with an interpolation of their valid neighbors.
+ *
+ * @param mask The mask, where nonzero values denote bad pixels
+ *
+ * @copydetails inpaint()
+ */
+template <typename TIn, typename TMask>
+requires(not std::integral<TMask>)
+auto inpaint(const TIn& in, const TMask& mask, Index radius = 2)
+{
+  SizeMismatch::may_throw("mask", mask.size(), in);
+  return Impl::inpaint_impl(in, as_readonly(mask), radius);
+}
+
+} // namespace Linx
+
+#endif
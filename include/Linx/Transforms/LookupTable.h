@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_LOOKUPTABLE_H
+#define _LINXTRANSFORMS_LOOKUPTABLE_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Base/mixins/Range.h" // is_contiguous
+#include "Linx/Data/Image.h"
+#include "Linx/Data/Sequence.h"
+
+#include <Kokkos_Core.hpp>
+#include <concepts>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace Linx {
+
+/**
+ * @brief Test whether a type can index a lookup table, i.e. is an integral type of 8 or 16 bits.
+ */
+template <typename T>
+constexpr bool is_lut_index()
+{
+  return std::is_integral_v<T> && not std::is_same_v<T, bool> && sizeof(T) <= 2;
+}
+
+namespace Impl {
+
+/**
+ * @brief The number of elements per team of the 8-bit lookup table kernel.
+ */
+constexpr Index lut_team_size = 4096;
+
+/**
+ * @brief Lookup table gather functor.
+ */
+template <typename T, typename U>
+struct LutGather {
+  const U* m_table; ///< The table
+
+  /**
+   * @brief Look up a value.
+   */
+  KOKKOS_INLINE_FUNCTION U operator()(T in) const
+  {
+    return m_table[static_cast<Index>(in) - std::numeric_limits<T>::lowest()];
+  }
+};
+
+/**
+ * @brief Apply a 256-element lookup table from team scratch memory.
+ *
+ * Each team copies the table into its scratch memory (shared memory on GPUs, L1 cache on CPUs),
+ * and then gathers a chunk of contiguous elements.
+ */
+template <typename TSpace, typename T, typename U>
+void apply_lut8(const T* in, U* out, Index size, const U* table)
+{
+  using Policy = Kokkos::TeamPolicy<TSpace>;
+  using Scratch = Kokkos::View<U*, typename TSpace::scratch_memory_space, Kokkos::MemoryUnmanaged>;
+  constexpr Index lowest = std::numeric_limits<T>::lowest();
+  constexpr Index range = 256;
+  const Index league = (size + lut_team_size - 1) / lut_team_size;
+  Kokkos::parallel_for(
+      "apply_lut()",
+      Policy(league, Kokkos::AUTO).set_scratch_size(0, Kokkos::PerTeam(Scratch::shmem_size(range))),
+      KOKKOS_LAMBDA(const typename Policy::member_type& team) {
+        Scratch cache(team.team_scratch(0), range);
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, range), [&](Index i) {
+          cache(i) = table[i];
+        });
+        team.team_barrier();
+        const auto begin = team.league_rank() * lut_team_size;
+        const auto end = Kokkos::min(begin + lut_team_size, size);
+        Kokkos::parallel_for(Kokkos::TeamThreadRange(team, begin, end), [&](Index i) {
+          out[i] = cache(static_cast<Index>(in[i]) - lowest);
+        });
+      });
+}
+
+} // namespace Impl
+
+/**
+ * @brief Tabulate a function over the whole range of an integral type.
+ *
+ * @tparam T The input type, of 8 or 16 bits
+ * @param func The function, which is evaluated once per possible input value, in parallel
+ * @return The table, whose `i`-th element is `func(T(std::numeric_limits<T>::lowest() + i))`
+ *
+ * \code
+ * auto gamma = make_lut<std::uint16_t>(KOKKOS_LAMBDA(std::uint16_t e) { return std::pow(e / 65535.F, 0.45F); });
+ * \endcode
+ *
+ * @see `apply_lut()`
+ */
+template <typename T, typename TFunc>
+requires(is_lut_index<T>())
+auto make_lut(const TFunc& func)
+{
+  using U = std::decay_t<std::invoke_result_t<TFunc, T>>;
+  using Space = Kokkos::DefaultExecutionSpace;
+  constexpr Index lowest = std::numeric_limits<T>::lowest();
+  constexpr Index range = Index(std::numeric_limits<T>::max()) - lowest + 1;
+  Sequence<U, -1> out("LUT", range);
+  auto out_ptr = out.data();
+  Kokkos::parallel_for(
+      "make_lut()",
+      Kokkos::RangePolicy<Space>(0, range),
+      KOKKOS_LAMBDA(Index i) { out_ptr[i] = func(static_cast<T>(i + lowest)); });
+  return out;
+}
+
+/**
+ * @brief Apply a lookup table to an image of 8- or 16-bit integers.
+ *
+ * @param in The input image
+ * @param table The table, as returned by `make_lut()`
+ * @return The image of the table value type
+ *
+ * This is a single gather pass.
+ * For contiguous 8-bit images, the table is first copied to team scratch memory,
+ * such that it remains cache- or shared-memory-resident during the gather.
+ */
+template <typename TIn, typename TTable>
+requires(is_lut_index<typename TIn::element_type>())
+auto apply_lut(const TIn& in, const TTable& table)
+{
+  using T = std::remove_cv_t<typename TIn::element_type>;
+  using U = std::remove_cv_t<typename TTable::element_type>;
+  using Space = typename TIn::execution_space;
+  constexpr Index range = Index(std::numeric_limits<T>::max()) - std::numeric_limits<T>::lowest() + 1;
+  OutOfBounds<'[', ']'>::may_throw("LUT size", Index(table.size()), {range, std::numeric_limits<Index>::max()});
+  Image<U, TIn::Rank> out(compose_label("apply_lut", in), in.shape());
+  if constexpr (sizeof(T) == 1 && is_contiguous<typename TIn::Container>()) {
+    Impl::apply_lut8<Space>(in.data(), out.data(), in.size(), table.data());
+  } else {
+    out.generate("apply_lut()", Impl::LutGather<T, U> {table.data()}, in);
+  }
+  return out;
+}
+
+/**
+ * @brief Apply a function to an image of 8- or 16-bit integers through a lookup table.
+ *
+ * This is equivalent to `apply_lut(in, make_lut<T>(func))`,
+ * such that the function is evaluated at most 65536 times, whatever the image size.
+ * To process several images, prefer building the table once with `make_lut()`.
+ */
+template <typename TIn, typename TFunc>
+requires(is_lut_index<typename TIn::element_type>())
+auto lut(const TIn& in, const TFunc& func)
+{
+  return apply_lut(in, make_lut<std::remove_cv_t<typename TIn::element_type>>(func));
+}
+
+} // namespace Linx
+
+#endif
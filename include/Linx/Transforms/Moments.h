@@ -0,0 +1,313 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_MOMENTS_H
+#define _LINXTRANSFORMS_MOMENTS_H
+
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Functional.h"
+#include "Linx/Base/Reduction.h"
+#include "Linx/Base/Types.h"
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Data/Sequence.h"
+
+#include <Kokkos_Core.hpp>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief The parameters of a moments measurement.
+ */
+struct MomentsParameters {
+  double sigma = 0; ///< The standard deviation of the initial Gaussian weight, or 0 for unweighted moments
+  int iterations = 1; ///< The maximum number of adaptive iterations, with Gaussian weights only
+  double tolerance = 1e-4; ///< The convergence tolerance on the centroid and second moments, in pixels and pixels^2
+};
+
+/**
+ * @brief The moments of a source.
+ *
+ * Coordinates are in pixels, in the frame of the image.
+ */
+template <typename T>
+struct Moments {
+  T flux; ///< The zeroth moment, i.e. the (weighted) sum of the values
+  T x; ///< The centroid along the first axis
+  T y; ///< The centroid along the second axis
+  T xx; ///< The second central moment along the first axis
+  T yy; ///< The second central moment along the second axis
+  T xy; ///< The second central cross-moment
+  int iterations; ///< The number of iterations
+  bool valid; ///< Whether the measurement succeeded, i.e. the flux and second moments are positive
+};
+
+namespace Impl {
+
+/**
+ * @brief The bounds and initial center of a stamp.
+ */
+template <typename T>
+struct MomentStamp {
+  Index x0; ///< The front along the first axis
+  Index y0; ///< The front along the second axis
+  Index x1; ///< The end along the first axis
+  Index y1; ///< The end along the second axis
+  T x; ///< The initial center along the first axis
+  T y; ///< The initial center along the second axis
+};
+
+/**
+ * @brief The partial sums of a moments measurement, relative to the current center.
+ */
+template <typename T>
+struct MomentSums {
+  T s; ///< The sum of the weighted values
+  T sx; ///< The first moment along the first axis
+  T sy; ///< The first moment along the second axis
+  T sxx; ///< The second moment along the first axis
+  T syy; ///< The second moment along the second axis
+  T sxy; ///< The second cross-moment
+
+  /**
+   * @brief Merge two partial sums.
+   */
+  KOKKOS_INLINE_FUNCTION MomentSums operator+(const MomentSums& rhs) const
+  {
+    return {s + rhs.s, sx + rhs.sx, sy + rhs.sy, sxx + rhs.sxx, syy + rhs.syy, sxy + rhs.sxy};
+  }
+};
+
+/**
+ * @brief Moments measurement functor, with one team per source.
+ *
+ * The team reduces the weighted sums of the stamp with a `MomentSums` reducer,
+ * the result of which is known by all threads,
+ * such that each thread updates the centroid and weight identically, without synchronization.
+ */
+template <typename TSpace, typename TIn, typename T>
+struct MomentsMeasurer {
+  using Policy = Kokkos::TeamPolicy<TSpace>;
+  using Member = typename Policy::member_type;
+  using Sums = MomentSums<T>;
+  using Reducer = Impl::Reducer<Sums, Add<Forward, Forward>, Kokkos::HostSpace>;
+
+  TIn m_in; ///< The image
+  Sequence<MomentStamp<T>, -1> m_stamps; ///< The stamps
+  Sequence<Moments<T>, -1> m_out; ///< The results
+  T m_sigma; ///< The initial weight standard deviation, or 0
+  int m_iterations; ///< The maximum number of iterations
+  T m_tolerance; ///< The convergence tolerance
+
+  /**
+   * @brief Measure a source.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(const Member& team) const
+  {
+    const auto stamp = m_stamps[team.league_rank()];
+    const Index width = Kokkos::min(stamp.x1, Index(m_in.extent(0))) - Kokkos::max(stamp.x0, Index(0));
+    const Index height = Kokkos::min(stamp.y1, Index(m_in.extent(1))) - Kokkos::max(stamp.y0, Index(0));
+    const Index x0 = Kokkos::max(stamp.x0, Index(0));
+    const Index y0 = Kokkos::max(stamp.y0, Index(0));
+    const bool weighted = m_sigma > 0;
+
+    Moments<T> out {T(0), stamp.x, stamp.y, m_sigma * m_sigma, m_sigma * m_sigma, T(0), 0, false};
+    const int iterations = weighted ? Kokkos::max(m_iterations, 1) : 1;
+    for (int it = 0; it < iterations && width > 0 && height > 0; ++it) {
+      const T det = out.xx * out.yy - out.xy * out.xy;
+      const T ixx = weighted ? out.yy / det : T(0);
+      const T iyy = weighted ? out.xx / det : T(0);
+      const T ixy = weighted ? -out.xy / det : T(0);
+      const T cx = out.x;
+      const T cy = out.y;
+      Sums sums {};
+      Kokkos::parallel_reduce(
+          Kokkos::TeamThreadRange(team, width * height),
+          [&](Index k, Sums& partial) {
+            const T dx = x0 + k % width - cx;
+            const T dy = y0 + k / width - cy;
+            const auto value = m_in(x0 + k % width, y0 + k / width);
+            if (not is_valid(value)) {
+              return;
+            }
+            const T distance2 = ixx * dx * dx + 2 * ixy * dx * dy + iyy * dy * dy;
+            const T weight = weighted ? Kokkos::exp(T(-0.5) * distance2) : T(1);
+            const T v = weight * static_cast<T>(value);
+            partial.s += v;
+            partial.sx += v * dx;
+            partial.sy += v * dy;
+            partial.sxx += v * dx * dx;
+            partial.syy += v * dy * dy;
+            partial.sxy += v * dx * dy;
+          },
+          Reducer(sums, Add(), Sums {}));
+
+      out.iterations = it + 1;
+      if (not(sums.s > 0)) {
+        out.valid = false;
+        break;
+      }
+      const T mx = sums.sx / sums.s;
+      const T my = sums.sy / sums.s;
+      const T cxx = sums.sxx / sums.s - mx * mx;
+      const T cyy = sums.syy / sums.s - my * my;
+      const T cxy = sums.sxy / sums.s - mx * my;
+      out.flux = sums.s;
+      out.x = cx + mx;
+      out.y = cy + my;
+      out.valid = cxx > 0 && cyy > 0 && cxx * cyy > cxy * cxy;
+      if (iterations == 1 || not out.valid) {
+        out.xx = cxx;
+        out.yy = cyy;
+        out.xy = cxy;
+        break;
+      }
+
+      // The weighted covariance of a Gaussian source with a matched weight is half the source covariance
+      const T dxx = 2 * cxx - out.xx;
+      const T dyy = 2 * cyy - out.yy;
+      const T dxy = 2 * cxy - out.xy;
+      out.xx += dxx;
+      out.yy += dyy;
+      out.xy += dxy;
+      const T shift = Kokkos::max(Kokkos::abs(mx), Kokkos::abs(my));
+      const T stretch = Kokkos::max(Kokkos::max(Kokkos::abs(dxx), Kokkos::abs(dyy)), Kokkos::abs(dxy));
+      if (Kokkos::max(shift, stretch) < m_tolerance) {
+        break;
+      }
+    }
+
+    Kokkos::single(Kokkos::PerTeam(team), [&]() {
+      m_out[team.league_rank()] = out;
+    });
+  }
+};
+
+/**
+ * @brief Measure the moments of a list of stamps.
+ */
+template <typename TIn, typename T>
+Sequence<Moments<T>, -1>
+measure_moments_impl(const TIn& in, const std::vector<MomentStamp<T>>& stamps, const MomentsParameters& parameters)
+{
+  static_assert(TIn::Rank == 2);
+  using Space = typename TIn::execution_space;
+  using Measurer = MomentsMeasurer<Space, std::decay_t<decltype(as_readonly(in))>, T>;
+  const Index count = stamps.size();
+  Sequence<MomentStamp<T>, -1> device_stamps("stamps", count);
+  auto stamps_on_host = on_host(device_stamps);
+  for (Index i = 0; i < count; ++i) {
+    stamps_on_host[i] = stamps[i];
+  }
+  Kokkos::deep_copy(device_stamps.container(), stamps_on_host.container());
+  Sequence<Moments<T>, -1> out(compose_label("measure_moments", in), count);
+  Kokkos::parallel_for(
+      "measure_moments()",
+      typename Measurer::Policy(count, Kokkos::AUTO),
+      Measurer {
+          as_readonly(in),
+          device_stamps,
+          out,
+          static_cast<T>(parameters.sigma),
+          parameters.iterations,
+          static_cast<T>(parameters.tolerance)});
+  return out;
+}
+
+/**
+ * @brief The floating point type of the moments of an image.
+ */
+template <typename TIn>
+using MomentsType = std::conditional_t<
+    std::is_floating_point_v<ComputeType<std::remove_cv_t<typename TIn::element_type>>>,
+    ComputeType<std::remove_cv_t<typename TIn::element_type>>,
+    float>;
+
+} // namespace Impl
+
+/**
+ * @brief Measure the moments of a batch of sources, given their stamps.
+ *
+ * @param in The image
+ * @param stamps The stamps, which are cropped to the image domain
+ * @param parameters The weighting and iteration parameters
+ * @return The moments, one per stamp
+ *
+ * All the sources are measured in a single kernel, with one team per source,
+ * which reduces the weighted sums of its stamp, iterates if needed, and writes its results.
+ * Invalid values, i.e. NaNs and infinities, are ignored.
+ *
+ * Three modes are available:
+ * - If `sigma` is 0, the moments are unweighted;
+ * - If `sigma` is positive and `iterations` is 1, the moments are weighted by a circular Gaussian
+ *   centered on the stamp center;
+ * - If `sigma` is positive and `iterations` is larger than 1, adaptive moments are computed:
+ *   at each iteration, the Gaussian weight is recentered on the weighted centroid,
+ *   and its covariance is set to twice the weighted covariance,
+ *   until the changes are smaller than `tolerance`.
+ *   At convergence, the second moments are those of the weight, which are those of the source if it is Gaussian,
+ *   while the flux is the weighted sum, which is half the total flux of a Gaussian source.
+ *
+ * \code
+ * auto moments = on_host(measure_moments(image, stamps, {.sigma = 2, .iterations = 20}));
+ * for (std::size_t i = 0; i < moments.size(); ++i) {
+ *   std::cout << moments[i].x << ", " << moments[i].y << std::endl;
+ * }
+ * \endcode
+ */
+template <typename TIn>
+auto measure_moments(const TIn& in, const std::vector<Box<2>>& stamps, const MomentsParameters& parameters = {})
+{
+  using T = Impl::MomentsType<TIn>;
+  std::vector<Impl::MomentStamp<T>> bounds;
+  bounds.reserve(stamps.size());
+  for (const auto& stamp : stamps) {
+    const auto& start = stamp.start();
+    const auto& stop = stamp.stop();
+    bounds.push_back(
+        {start[0], start[1], stop[0], stop[1], T(start[0] + stop[0] - 1) / 2, T(start[1] + stop[1] - 1) / 2});
+  }
+  return Impl::measure_moments_impl(in, bounds, parameters);
+}
+
+/**
+ * @brief Measure the moments of a batch of sources, given their approximate centers.
+ *
+ * @param in The image
+ * @param centers The initial centers
+ * @param radius The radius of the square stamps around the rounded centers
+ * @param parameters The weighting and iteration parameters
+ *
+ * The Gaussian weights, if any, are initially centered on the given centers instead of the stamp centers.
+ *
+ * @copydetails measure_moments()
+ */
+template <typename TIn>
+auto measure_moments(
+    const TIn& in,
+    const std::vector<std::array<double, 2>>& centers,
+    Index radius,
+    const MomentsParameters& parameters = {})
+{
+  using T = Impl::MomentsType<TIn>;
+  OutOfBounds<'[', ']'>::may_throw("stamp radius", radius, {Index(0), std::numeric_limits<Index>::max()});
+  std::vector<Impl::MomentStamp<T>> bounds;
+  bounds.reserve(centers.size());
+  for (const auto& center : centers) {
+    const Index x = std::lround(center[0]);
+    const Index y = std::lround(center[1]);
+    bounds.push_back({x - radius, y - radius, x + radius + 1, y + radius + 1, T(center[0]), T(center[1])});
+  }
+  return Impl::measure_moments_impl(in, bounds, parameters);
+}
+
+} // namespace Linx
+
+#endif
@@ -7,12 +7,14 @@
 
 #include "Linx/Base/Algorithm.h"
 #include "Linx/Base/ArrayPool.h"
+#include "Linx/Base/Types.h"
 #include "Linx/Data/Image.h"
 #include "Linx/Data/Sequence.h"
 #include "Linx/Transforms/mixins/FilterMixin.h"
 
 #include <concepts>
 #include <string>
+#include <type_traits>
 
 namespace Linx {
 
@@ -25,7 +27,9 @@ public:
 
   MedianFilter(const TStrel& strel, const TIn& in) :
       MorphologyFilterMixin<TIn, MedianFilter>(strel, in), m_neighbors(this->m_offsets.size())
-  {}
+  {
+    this->instrument(label());
+  }
 
   MedianFilter(TParity, const TStrel& strel, const TIn& in) : MedianFilter(strel, in)
   {
@@ -41,17 +45,89 @@ public:
 
   KOKKOS_INLINE_FUNCTION auto operator()(const std::integral auto&... is) const
   {
-    auto array = m_neighbors.array();
+    auto array = m_neighbors.array(this->m_counters);
     auto in_ptr = &this->m_in(is...);
     for (std::size_t i = 0; i < array.size(); ++i) {
       array[i] = in_ptr[this->m_offsets[i]];
     }
-    return median<TParity>(array);
+    this->m_counters.add(Counter::Taps, array.size());
+    this->m_counters.count_element();
+    return median<TParity>(array, this->m_counters);
+  }
+
+private:
+
+  ArrayPool<element_type> m_neighbors; // FIXME TSpace
+};
+
+/**
+ * @brief Median filter which skips invalid input values.
+ *
+ * NaNs and infinities, as well as values with nonzero mask values if any, are excluded from the neighborhood.
+ * If no value is valid, the output is NaN.
+ * The mask must have the same layout as the input.
+ */
+template <typename TStrel, typename TIn, typename TMask = void>
+class NanMedianFilter : public MorphologyFilterMixin<TIn, NanMedianFilter<TStrel, TIn, TMask>> {
+public:
+
+  static constexpr bool Masked = not std::is_void_v<TMask>;
+  using value_type = typename TIn::value_type;
+  using element_type = std::remove_cvref_t<value_type>;
+  using MaskInput = std::conditional_t<Masked, TMask, TIn>; ///< The mask parameter type
+
+  NanMedianFilter(const TStrel& strel, const TIn& in) :
+      MorphologyFilterMixin<TIn, NanMedianFilter>(strel, in), m_neighbors(this->m_offsets.size()), m_mask()
+  {
+    this->instrument(label());
+  }
+
+  NanMedianFilter(const TStrel& strel, const TIn& in, const MaskInput& mask)
+  requires(Masked)
+      : NanMedianFilter(strel, in)
+  {
+    Impl::check_same_layout("mask", in, mask);
+    m_mask = as_readonly(mask);
+  }
+
+  std::string label() const
+  {
+    return "NanMedianFilter";
+  }
+
+  KOKKOS_INLINE_FUNCTION auto operator()(const std::integral auto&... is) const
+  {
+    auto array = m_neighbors.array(this->m_counters);
+    const auto in_ptr = &this->m_in(is...);
+    const auto mask_ptr = [&]() {
+      if constexpr (Masked) {
+        return &m_mask(is...);
+      } else {
+        return nullptr;
+      }
+    }();
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < array.size(); ++i) {
+      const auto offset = this->m_offsets[i];
+      const auto value = in_ptr[offset];
+      bool valid = is_valid(value);
+      if constexpr (Masked) {
+        valid = valid && not mask_ptr[offset];
+      }
+      if (valid) {
+        array[size++] = value;
+      }
+    }
+    this->m_counters.add(Counter::Taps, array.size());
+    this->m_counters.count_element();
+    Impl::Prefix<decltype(array)> kept {array, size};
+    return size ? element_type(median(kept, this->m_counters)) : invalid_value<element_type>();
   }
 
 private:
 
   ArrayPool<element_type> m_neighbors; // FIXME TSpace
+  Impl::OptionalInput<TMask> m_mask; ///< The mask, if any
 };
 
 template <typename TStrel, typename TIn, typename TParity = Forward>
@@ -61,7 +137,10 @@ public:
   using value_type = typename TIn::value_type;
   using element_type = std::remove_cvref_t<value_type>;
 
-  MinFilter(const TStrel& strel, const TIn& in) : MorphologyFilterMixin<TIn, MinFilter>(strel, in) {}
+  MinFilter(const TStrel& strel, const TIn& in) : MorphologyFilterMixin<TIn, MinFilter>(strel, in)
+  {
+    this->instrument(label());
+  }
 
   // TODO MinFilter(std::integral auto radius, const TIn& in)
 
@@ -77,6 +156,8 @@ public:
     for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
       out = std::min<element_type>(out, in_ptr[this->m_offsets[i]]);
     }
+    this->m_counters.add(Counter::Taps, this->m_offsets.size());
+    this->m_counters.count_element();
     return out;
   }
 };
@@ -88,7 +169,10 @@ public:
   using value_type = typename TIn::value_type;
   using element_type = std::remove_cvref_t<value_type>;
 
-  MaxFilter(const TStrel& strel, const TIn& in) : MorphologyFilterMixin<TIn, MaxFilter>(strel, in) {}
+  MaxFilter(const TStrel& strel, const TIn& in) : MorphologyFilterMixin<TIn, MaxFilter>(strel, in)
+  {
+    this->instrument(label());
+  }
 
   // TODO MaxFilter(std::integral auto radius, const TIn& in)
 
@@ -104,6 +188,8 @@ public:
     for (std::size_t i = 0; i < this->m_offsets.size(); ++i) {
       out = std::max<element_type>(out, in_ptr[this->m_offsets[i]]);
     }
+    this->m_counters.add(Counter::Taps, this->m_offsets.size());
+    this->m_counters.count_element();
     return out;
   }
 };
@@ -179,6 +265,50 @@ auto max_filter(const std::string& label, Index radius, const TIn& in)
   return out;
 }
 
+/**
+ * @brief Median-filter an image, skipping the invalid values.
+ *
+ * @param label The output label
+ * @param radius The radius of the box neighborhood
+ * @param in The input image
+ *
+ * As opposed to `median_filter()`, NaNs and infinities are excluded from the neighborhoods.
+ * The output extent along axis `i` is `in.extent(i) - 2 * radius`.
+ */
+template <typename TIn>
+auto nanmedian_filter(const std::string& label, Index radius, const TIn& in)
+{
+  constexpr auto N = TIn::Rank;
+  const auto rank = in.rank();
+  auto strel = Box(Position<N>(Constant(-radius), rank), Position<N>(Constant(radius + 1), rank));
+
+  auto bbox = +strel; // FIXME box(strel)
+  TIn out(label, in.shape() - bbox.shape() + 1);
+  out.copy_from(NanMedianFilter(strel - bbox.start(), in));
+  return out;
+}
+
+/**
+ * @brief Median-filter an image, skipping the invalid and masked values.
+ *
+ * @param mask The mask, where nonzero values denote invalid pixels, of same shape and layout as `in`
+ *
+ * @copydetails nanmedian_filter()
+ */
+template <typename TIn, typename TMask>
+auto nanmedian_filter(const std::string& label, Index radius, const TIn& in, const TMask& mask)
+{
+  constexpr auto N = TIn::Rank;
+  const auto rank = in.rank();
+  auto strel = Box(Position<N>(Constant(-radius), rank), Position<N>(Constant(radius + 1), rank));
+
+  auto bbox = +strel; // FIXME box(strel)
+  auto shifted = strel - bbox.start();
+  TIn out(label, in.shape() - bbox.shape() + 1);
+  out.copy_from(NanMedianFilter<decltype(shifted), TIn, TMask>(shifted, in, mask));
+  return out;
+}
+
 } // namespace Linx
 
 #endif
@@ -0,0 +1,312 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STACKING_H
+#define _LINXTRANSFORMS_STACKING_H
+
+#include "Linx/Base/Algorithm.h"
+#include "Linx/Base/ArrayPool.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Transforms/mixins/FilterMixin.h"
+
+#include <Kokkos_Core.hpp>
+#include <cmath>
+#include <concepts>
+#include <ranges>
+#include <string>
+
+namespace Linx {
+
+/**
+ * @brief Median combination method.
+ */
+struct Median {
+  /**
+   * @brief Combine the values of a line (which are shuffled).
+   */
+  template <typename TInOut>
+  KOKKOS_INLINE_FUNCTION auto operator()(TInOut& values) const
+  {
+    return median(values);
+  }
+};
+
+/**
+ * @brief Mean combination method.
+ */
+struct Mean {
+  /**
+   * @brief Combine the values of a line.
+   */
+  template <typename TInOut>
+  KOKKOS_INLINE_FUNCTION auto operator()(TInOut& values) const
+  {
+    double sum = 0;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      sum += values[i];
+    }
+    return sum / values.size();
+  }
+};
+
+/**
+ * @brief Sigma-clipped mean combination method.
+ *
+ * At each iteration, the values farther than `nsigma` standard deviations from the median are rejected,
+ * where the standard deviation is computed around the median.
+ * Iterations stop when no value is rejected or after `iterations` iterations,
+ * and the mean of the remaining values is returned.
+ * If all the values would be rejected, the previous iteration is kept.
+ */
+struct ClippedMean {
+  double nsigma = 3; ///< The rejection threshold in standard deviations
+  int iterations = 5; ///< The maximum number of iterations
+
+  /**
+   * @brief Combine the values of a line (which are shuffled).
+   */
+  template <typename TInOut>
+  KOKKOS_INLINE_FUNCTION auto operator()(TInOut& values) const
+  {
+    Impl::Prefix<TInOut> kept {values, values.size()};
+    for (int it = 0; it < iterations; ++it) {
+      const double center = median(kept);
+      double sum2 = 0;
+      for (std::size_t i = 0; i < kept.size(); ++i) {
+        const double diff = kept[i] - center;
+        sum2 += diff * diff;
+      }
+      const double bound = nsigma * Kokkos::sqrt(sum2 / kept.size());
+      std::size_t count = 0;
+      for (std::size_t i = 0; i < kept.size(); ++i) {
+        count += Kokkos::abs(kept[i] - center) <= bound;
+      }
+      if (count == kept.size() || count == 0) {
+        break;
+      }
+      std::size_t j = 0;
+      for (std::size_t i = 0; i < kept.size(); ++i) {
+        if (Kokkos::abs(kept[i] - center) <= bound) {
+          kept[j++] = kept[i];
+        }
+      }
+      kept.m_size = count;
+    }
+    return Mean()(kept);
+  }
+};
+
+namespace Impl {
+
+/**
+ * @brief The lines of a cube along an axis, which are read in place.
+ */
+template <typename T, int M>
+struct CubeLines {
+  const T* m_data; ///< The cube data
+  Kokkos::Array<std::ptrdiff_t, M> m_strides; ///< The strides of the non-stacking axes
+  std::ptrdiff_t m_step; ///< The stride of the stacking axis
+
+  /**
+   * @brief The offset of the line at given position.
+   */
+  KOKKOS_INLINE_FUNCTION std::ptrdiff_t offset(std::integral auto... is) const
+  {
+    std::ptrdiff_t out = 0;
+    int k = 0;
+    ((out += is * m_strides[k++]), ...);
+    return out;
+  }
+
+  /**
+   * @brief The `k`-th value of the line at given offset.
+   */
+  KOKKOS_INLINE_FUNCTION const T& operator()(std::ptrdiff_t offset, Index k) const
+  {
+    return m_data[offset + k * m_step];
+  }
+};
+
+/**
+ * @brief Pointer to the data of a frame.
+ */
+template <typename T>
+struct FramePointer {
+  const T* data; ///< The data
+};
+
+/**
+ * @brief The lines of a list of frames, which are read in place.
+ */
+template <typename T, int M, typename TSpace>
+struct FrameLines {
+  Kokkos::View<FramePointer<T>*, typename TSpace::memory_space> m_frames; ///< The frames data
+  Kokkos::Array<std::ptrdiff_t, M> m_strides; ///< The strides of the frames
+
+  /**
+   * @brief The offset of the line at given position.
+   */
+  KOKKOS_INLINE_FUNCTION std::ptrdiff_t offset(std::integral auto... is) const
+  {
+    std::ptrdiff_t out = 0;
+    int k = 0;
+    ((out += is * m_strides[k++]), ...);
+    return out;
+  }
+
+  /**
+   * @brief The `k`-th value of the line at given offset.
+   */
+  KOKKOS_INLINE_FUNCTION const T& operator()(std::ptrdiff_t offset, Index k) const
+  {
+    return m_frames(k).data[offset];
+  }
+};
+
+/**
+ * @brief Combine each line of a stack into an output element.
+ *
+ * Each thread gathers its line into an array of the pool, which the method may shuffle.
+ */
+template <typename TLines, typename TOut, typename TMethod, typename TSpace>
+struct StackCombiner {
+  using element_type = typename TOut::element_type; ///< The output element type
+
+  TLines m_lines; ///< The input lines
+  TOut m_out; ///< The output
+  TMethod m_method; ///< The combination method
+  Index m_depth; ///< The line length
+  ArrayPool<element_type, TSpace> m_pool; ///< The per-thread scratch memory
+
+  /**
+   * @brief Constructor.
+   */
+  StackCombiner(const TLines& lines, const TOut& out, const TMethod& method, Index depth) :
+      m_lines(lines), m_out(out), m_method(method), m_depth(depth),
+      m_pool(std::is_same_v<TMethod, Mean> ? 1 : depth)
+  {}
+
+  /**
+   * @brief Combine the line at given position.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(std::integral auto... is) const
+  {
+    const auto offset = m_lines.offset(is...);
+    if constexpr (std::is_same_v<TMethod, Mean>) { // No need for scratch memory
+      double sum = 0;
+      for (Index k = 0; k < m_depth; ++k) {
+        sum += m_lines(offset, k);
+      }
+      m_out(is...) = sum / m_depth;
+    } else {
+      auto array = m_pool.array();
+      for (Index k = 0; k < m_depth; ++k) {
+        array[k] = m_lines(offset, k);
+      }
+      m_out(is...) = m_method(array);
+    }
+  }
+};
+
+} // namespace Impl
+
+/**
+ * @brief Combine the lines of a cube along a given axis.
+ *
+ * @tparam I The stacking axis
+ * @param cube The input image of rank N
+ * @param method The combination method, e.g. `Median()`, `Mean()` or `ClippedMean {3, 5}`
+ * @return The image of rank N - 1 and the same value type
+ *
+ * The lines are read in place, whatever the stacking axis, i.e. the cube is not transposed.
+ */
+template <int I, typename TIn, typename TMethod>
+auto combine(const TIn& cube, const TMethod& method)
+{
+  constexpr auto N = TIn::Rank;
+  static_assert(N > 1 && I >= 0 && I < N);
+  using T = typename TIn::element_type;
+  using Space = typename TIn::execution_space;
+
+  Position<N - 1> shape;
+  Impl::CubeLines<T, N - 1> lines {cube.data(), {}, static_cast<std::ptrdiff_t>(cube.container().stride(I))};
+  for (int k = 0; k < N - 1; ++k) {
+    const auto axis = k < I ? k : k + 1;
+    shape[k] = cube.extent(axis);
+    lines.m_strides[k] = cube.container().stride(axis);
+  }
+  Image<T, N - 1> out(compose_label("combine", cube), shape);
+  for_each<Space>(
+      "combine()",
+      out.domain(),
+      Impl::StackCombiner<decltype(lines), decltype(out), TMethod, Space>(lines, out, method, cube.extent(I)));
+  return out;
+}
+
+/**
+ * @brief Combine a list of frames element-wise.
+ *
+ * @param frames A range of images of the same shape and strides
+ * @param method The combination method, e.g. `Median()`, `Mean()` or `ClippedMean {3, 5}`
+ * @return The image of the same shape and value type as the frames
+ *
+ * The frames are read in place, i.e. they are not copied into a cube.
+ */
+template <std::ranges::range TFrames, typename TMethod>
+auto combine(const TFrames& frames, const TMethod& method)
+{
+  using TIn = std::ranges::range_value_t<TFrames>;
+  constexpr auto N = TIn::Rank;
+  using T = typename TIn::element_type;
+  using Space = typename TIn::execution_space;
+
+  const auto& front = *std::ranges::begin(frames);
+  const Index depth = std::ranges::distance(frames);
+  Impl::FrameLines<T, N, Space> lines {
+      Kokkos::View<Impl::FramePointer<T>*, typename Space::memory_space>("frames", depth),
+      {}};
+  for (int k = 0; k < N; ++k) {
+    lines.m_strides[k] = front.container().stride(k);
+  }
+  auto frames_on_host = Kokkos::create_mirror_view(lines.m_frames);
+  Index k = 0;
+  for (const auto& frame : frames) {
+    Impl::check_same_layout("frame", front, frame);
+    frames_on_host(k++).data = frame.data();
+  }
+  Kokkos::deep_copy(lines.m_frames, frames_on_host);
+
+  Image<T, N> out(compose_label("combine", front), front.shape());
+  for_each<Space>(
+      "combine()",
+      out.domain(),
+      Impl::StackCombiner<decltype(lines), decltype(out), TMethod, Space>(lines, out, method, depth));
+  return out;
+}
+
+/**
+ * @brief Compute the median of a cube along a given axis.
+ * @see `combine()`
+ */
+template <int I, typename TIn>
+auto median(const TIn& cube)
+{
+  return combine<I>(cube, Median());
+}
+
+/**
+ * @brief Compute the sigma-clipped mean of a cube along a given axis.
+ * @see `combine()`
+ * @see `ClippedMean`
+ */
+template <int I, typename TIn>
+auto clipped_mean(const TIn& cube, double nsigma = 3, int iterations = 5)
+{
+  return combine<I>(cube, ClippedMean {nsigma, iterations});
+}
+
+} // namespace Linx
+
+#endif
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef _LINXTRANSFORMS_STREAMINGSTACKING_H
+#define _LINXTRANSFORMS_STREAMINGSTACKING_H
+
+#include "Linx/Data/Box.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Transforms/Stacking.h"
+
+#include <Kokkos_Core.hpp>
+#include <algorithm> // min
+#include <array>
+#include <functional>
+#include <future>
+#include <string>
+#include <thread>
+#include <tuple> // apply
+#include <vector>
+
+namespace Linx {
+
+/**
+ * @brief Running mean and variance of a stream of frames.
+ *
+ * Frames are pushed one at a time and accumulated with Welford's updates,
+ * such that memory is bounded by two images, whatever the number of frames.
+ *
+ * \code
+ * RunningStatistics<float, 2> stats(shape);
+ * for (const auto& filename : filenames) {
+ *   stats.push(read(filename));
+ * }
+ * const auto& mean = stats.mean();
+ * const auto variance = stats.variance();
+ * \endcode
+ */
+template <typename T, int N>
+class RunningStatistics {
+public:
+
+  /**
+   * @brief Constructor.
+   */
+  explicit RunningStatistics(const Position<N>& shape) : m_count(0), m_mean("mean", shape), m_m2("m2", shape) {}
+
+  /**
+   * @brief Accumulate a frame.
+   */
+  template <typename TIn>
+  void push(const TIn& frame)
+  {
+    SizeMismatch::may_throw("frame", frame.size(), m_mean);
+    ++m_count;
+    const T count = m_count;
+    m_m2.generate_with_side_effects(
+        "push()",
+        KOKKOS_LAMBDA(T m2, T & mean, T x) {
+          const auto delta = x - mean;
+          mean += delta / count;
+          return m2 + delta * (x - mean);
+        },
+        m_m2,
+        m_mean,
+        as_readonly(frame));
+  }
+
+  /**
+   * @brief The number of accumulated frames.
+   */
+  Index count() const
+  {
+    return m_count;
+  }
+
+  /**
+   * @brief The running mean.
+   */
+  const Image<T, N>& mean() const
+  {
+    return m_mean;
+  }
+
+  /**
+   * @brief Compute the variance.
+   * @param ddof The delta degrees of freedom, i.e. the variance is the sum of squared deviations over `count - ddof`
+   */
+  Image<T, N> variance(Index ddof = 1) const
+  {
+    auto out = m_m2.copy_as("variance");
+    out /= T(m_count - ddof);
+    return out;
+  }
+
+private:
+
+  Index m_count; ///< The number of frames
+  Image<T, N> m_mean; ///< The running mean
+  Image<T, N> m_m2; ///< The running sum of squared deviations
+};
+
+/**
+ * @brief Row-major host image which is filled by frame sources.
+ */
+template <typename T, int N>
+using HostImage = Image<T, N, typename DefaultContainer<T, N, Kokkos::LayoutRight, Kokkos::HostSpace>::Image>;
+
+/**
+ * @brief A frame source, which reads a region of a frame.
+ *
+ * A source is called with a region of the frame and a host image of the region shape,
+ * which it should fill with the frame values in the region, e.g. by reading a file.
+ * Sources are called concurrently from several threads.
+ */
+template <typename T, int N>
+using FrameSource = std::function<void(const Box<N>&, const HostImage<T, N>&)>;
+
+namespace Impl {
+
+/**
+ * @brief Call a host function on each position of a shape, in raster order, outside of any Kokkos kernel.
+ *
+ * This is a plain loop for host-side orchestration, e.g. when the function allocates images or launches kernels.
+ * It neither allocates nor requires a specific Kokkos backend, and can therefore be called from any host thread.
+ */
+template <std::size_t N, typename TFunc>
+void for_each_on_host(const std::array<Index, N>& shape, TFunc&& func)
+{
+  for (auto extent : shape) {
+    if (extent <= 0) {
+      return;
+    }
+  }
+  std::array<Index, N> indices {};
+  while (true) {
+    std::apply(func, indices);
+    std::size_t k = 0;
+    for (; k < N; ++k) {
+      if (++indices[k] < shape[k]) {
+        break;
+      }
+      indices[k] = 0;
+    }
+    if (k == N) {
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Copy an image region into a host image.
+ */
+template <typename TIn, typename T, int N, std::size_t... Is>
+void read_region(const TIn& in, const Box<N>& region, const HostImage<T, N>& out, std::index_sequence<Is...>)
+{
+  const std::array<Index, N> shape {Index(out.extent(Is))...};
+  const std::array<Index, N> start {Index(region.start(Is))...};
+  for_each_on_host(shape, [&](auto... js) {
+    out(js...) = in((js + start[Is])...);
+  });
+}
+
+/**
+ * @brief Copy a tile into an image at some position.
+ */
+template <typename TIn, typename TOut>
+struct Paster {
+  TIn m_in; ///< The tile
+  TOut m_out; ///< The output
+  Kokkos::Array<Index, TIn::Rank> m_start; ///< The tile position in the output
+
+  /**
+   * @brief Copy the element at given tile position.
+   */
+  KOKKOS_INLINE_FUNCTION void operator()(std::integral auto... is) const
+  {
+    paste(std::make_index_sequence<sizeof...(is)>(), is...);
+  }
+
+  /**
+   * @brief Helper to unfold the axes.
+   */
+  template <std::size_t... Ks>
+  KOKKOS_INLINE_FUNCTION void paste(std::index_sequence<Ks...>, std::integral auto... is) const
+  {
+    m_out((is + m_start[Ks])...) = m_in(is...);
+  }
+};
+
+} // namespace Impl
+
+/**
+ * @brief Make a frame source from an image, e.g. for testing.
+ *
+ * The image is copied to host once.
+ */
+template <typename TIn>
+FrameSource<typename TIn::element_type, TIn::Rank> frame_source(const TIn& in)
+{
+  using T = typename TIn::element_type;
+  constexpr auto N = TIn::Rank;
+  auto in_on_host = on_host(in);
+  return [in_on_host](const Box<N>& region, const HostImage<T, N>& out) {
+    Impl::read_region(in_on_host, region, out, std::make_index_sequence<N>());
+  };
+}
+
+/**
+ * @brief Combine a stack of frames tile by tile.
+ *
+ * @param sources The frame sources
+ * @param shape The frame shape
+ * @param tile The maximum tile shape
+ * @param method The combination method, e.g. `Median()` or `ClippedMean {3, 5}`
+ * @param threads The maximum number of concurrent reads, or 0 for the hardware concurrency
+ *
+ * For each tile, the sources are read concurrently into a host cube of the frame count times the tile shape,
+ * in which each frame is contiguous.
+ * The cube is copied to the device and combined along the frame axis with `combine()`.
+ * The memory footprint is therefore bounded by the tile size times the frame count,
+ * twice if the device is not the host.
+ *
+ * For mean and variance, `RunningStatistics` is a frame-by-frame alternative.
+ */
+template <typename T, int N, typename TMethod>
+Image<T, N> combine_tiled(
+    const std::vector<FrameSource<T, N>>& sources,
+    const Position<N>& shape,
+    const Position<N>& tile,
+    const TMethod& method,
+    int threads = 0)
+{
+  using Space = typename Image<T, N>::execution_space;
+  const Index depth = sources.size();
+  if (threads <= 0) {
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  threads = std::min<int>(threads, depth);
+
+  Image<T, N> out("combine_tiled", shape);
+  std::array<Index, N> grid;
+  for (int k = 0; k < N; ++k) {
+    grid[k] = (shape[k] + tile[k] - 1) / tile[k];
+  }
+  Impl::for_each_on_host(grid, [&](auto... ts) {
+    Position<N> start {static_cast<Index>(ts)...};
+    Position<N> stop;
+    for (int k = 0; k < N; ++k) {
+      start[k] *= tile[k];
+      stop[k] = std::min(start[k] + tile[k], shape[k]);
+    }
+    const Box<N> region(start, stop);
+    const auto tile_shape = region.shape();
+    const auto tile_size = region.size();
+
+    // Frame k is the contiguous, row-major block which starts at k * tile_size, like a `HostImage`
+    Position<N + 1> cube_shape;
+    cube_shape[0] = depth;
+    for (int k = 0; k < N; ++k) {
+      cube_shape[k + 1] = tile_shape[k];
+    }
+    Image<T, N + 1, typename DefaultContainer<T, N + 1, Kokkos::LayoutRight>::Image> cube("tile", cube_shape);
+    auto cube_on_host = Kokkos::create_mirror_view(cube.container());
+
+    std::vector<std::future<void>> reads;
+    for (int t = 0; t < threads; ++t) {
+      reads.push_back(std::async(std::launch::async, [&, t]() {
+        for (Index k = t; k < depth; k += threads) {
+          HostImage<T, N> frame(Wrap(cube_on_host.data() + k * tile_size), tile_shape);
+          sources[k](region, frame);
+        }
+      }));
+    }
+    for (auto& read : reads) {
+      read.get(); // Rethrows
+    }
+    Kokkos::deep_copy(cube.container(), cube_on_host);
+
+    const auto combined = combine<0>(cube, method);
+    Kokkos::Array<Index, N> offset;
+    for (int k = 0; k < N; ++k) {
+      offset[k] = start[k];
+    }
+    for_each<Space>(
+        "combine_tiled()",
+        combined.domain(),
+        Impl::Paster<std::decay_t<decltype(combined)>, Image<T, N>> {combined, out, offset});
+  });
+  return out;
+}
+
+} // namespace Linx
+
+#endif
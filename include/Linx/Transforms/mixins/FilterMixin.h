@@ -6,12 +6,58 @@
 #define _LINXTRANSFORMS_FILTERMIXIN_H
 
 #include "Linx/Base/ArrayPool.h"
+#include "Linx/Base/Exceptions.h"
+#include "Linx/Base/Functional.h"
+#include "Linx/Base/Instrumentation.h"
+#include "Linx/Base/Types.h"
 #include "Linx/Data/Sequence.h"
 
 #include <string>
+#include <type_traits>
+#include <utility> // declval
 
 namespace Linx {
 
+namespace Impl {
+
+/**
+ * @brief Throw if an auxiliary image, e.g. a variance or a mask, does not have the shape and strides of an image.
+ */
+void check_same_layout(const std::string& name, const auto& in, const auto& other)
+{
+  SizeMismatch::may_throw(name, other.size(), in);
+  for (int i = 0; i < in.rank(); ++i) {
+    const Index extent = in.extent(i);
+    OutOfBounds<'[', ']'>::may_throw(name + " extent", Index(other.extent(i)), {extent, extent});
+    const Index stride = in.container().stride(i);
+    OutOfBounds<'[', ']'>::may_throw(name + " stride", Index(other.container().stride(i)), {stride, stride});
+  }
+}
+
+/**
+ * @brief Helper for `OptionalInput`.
+ */
+template <typename T>
+struct OptionalInputTrait {
+  using type = std::decay_t<decltype(as_readonly(std::declval<T>()))>;
+};
+
+/**
+ * @brief Helper for `OptionalInput`.
+ */
+template <>
+struct OptionalInputTrait<void> {
+  using type = Forward;
+};
+
+/**
+ * @brief The member type of an optional auxiliary image, e.g. a variance or a mask, or `Forward` if it is `void`.
+ */
+template <typename T>
+using OptionalInput = typename OptionalInputTrait<T>::type;
+
+} // namespace Impl
+
 template <typename TIn, typename TDerived>
 class MorphologyFilterMixin { // FIXME simply FilterMixin?
 public:
@@ -35,11 +81,22 @@ public:
 protected:
 
   MorphologyFilterMixin(const Sequence<std::ptrdiff_t, -1>& offsets, const TIn& in) :
-      m_offsets(offsets), m_in(as_readonly(in))
+      m_offsets(offsets), m_in(as_readonly(in)), m_counters()
   {}
 
+  /**
+   * @brief Register the hot-path counters of the filter.
+   * 
+   * This is a no-op unless `LINX_INSTRUMENTATION` is defined.
+   */
+  void instrument(const std::string& label)
+  {
+    m_counters = make_counters(label);
+  }
+
   Sequence<std::ptrdiff_t, -1> m_offsets;
   decltype(as_readonly(std::declval<TIn>())) m_in;
+  Counters m_counters; ///< The hot-path counters
 };
 
 template <typename TIn, typename TDerived>
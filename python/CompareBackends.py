@@ -0,0 +1,74 @@
+"""
+Run the Linx benchmarks built against several Kokkos backends over the same parameter sweep,
+check that the outputs agree, and report a comparison table.
+
+The backends are built with the CMake option `LINX_BACKEND_PREFIXES`, in `<build>/backends/<name>`.
+"""
+
+from argparse import ArgumentParser
+import csv
+import itertools
+import os
+import sys
+
+from CompareBenchmarks import BENCHMARKS, agree, parse, run
+
+
+if __name__ == "__main__":
+
+    parser = ArgumentParser(description="Compare Linx benchmarks across Kokkos backends")
+    parser.add_argument("--build", type=str, default="build", help="The build directory")
+    parser.add_argument("--backends", nargs="+", default=None, help="The backend names (default: all built)")
+    parser.add_argument("--benchmarks", nargs="+", default=list(BENCHMARKS), choices=list(BENCHMARKS))
+    parser.add_argument("--threads", type=int, default=0, help="The number of threads, or 0 for the Kokkos default")
+    parser.add_argument("--tolerance", type=float, default=1e-4, help="The relative tolerance of the checks")
+    parser.add_argument("--csv", type=str, default=None, help="An optional output CSV file")
+    args = parser.parse_args()
+
+    root = os.path.join(args.build, "backends")
+    backends = args.backends or sorted(os.listdir(root))
+    if not backends:
+        sys.exit(f"No backend found in {root}")
+
+    rows = []
+    failures = 0
+    for name in args.benchmarks:
+        benchmark = BENCHMARKS[name]
+        keys = list(benchmark["sweep"])
+        for values in itertools.product(*benchmark["sweep"].values()):
+            options = list(itertools.chain(*[[f"--{k}", str(v)] for k, v in zip(keys, values)]))
+            options += ["--quiet", "--threads", str(args.threads)]
+            outputs = {b: run([os.path.join(root, b, benchmark["cpp"])] + options) for b in backends}
+
+            checks = {b: parse(outputs[b], benchmark["checks"]) for b in backends}
+            reference = checks[backends[0]]
+            ok = all(agree(checks[b][c], reference[c], args.tolerance) for b in backends for c in reference)
+            if not ok:
+                failures += 1
+
+            timings = {b: parse(outputs[b], benchmark["timings"]) for b in backends}
+            parameters = " ".join(f"{k}={v}" for k, v in zip(keys, values))
+            for timing in benchmark["timings"]:
+                times = {b: float(timings[b][timing]) for b in backends}
+                best = min(times, key=times.get)
+                rows.append([name, parameters, timing] + [times[b] for b in backends] + [best, "OK" if ok else "FAILED"])
+
+    header = ["Benchmark", "Parameters", "Timing"] + [f"{b} (s)" for b in backends] + ["Best", "Check"]
+    print(f"{header[0]:<14}{header[1]:<36}{header[2]:<12}" + "".join(f"{h:>14}" for h in header[3:-2]) + "  Best  Check")
+    for row in rows:
+        times = "".join(f"{t:>14.4g}" for t in row[3:-2])
+        print(f"{row[0]:<14}{row[1]:<36}{row[2]:<12}{times}  {row[-2]}  {row[-1]}")
+
+    wins = {b: sum(1 for row in rows if row[-2] == b) for b in backends}
+    print("\nBest backend count: " + ", ".join(f"{b}: {n}" for b, n in wins.items()))
+
+    if args.csv:
+        with open(args.csv, "w", newline="") as f:
+            writer = csv.writer(f)
+            writer.writerow(header)
+            writer.writerows(rows)
+        print(f"Results written to: {args.csv}")
+
+    if failures:
+        print(f"\n{failures} mismatch(es) between backends")
+        sys.exit(1)
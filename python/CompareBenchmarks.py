@@ -0,0 +1,118 @@
+"""
+Run the Linx benchmarks and their NumPy/SciPy references over a parameter sweep,
+check that the outputs agree, and report the speedups.
+
+Both sides print the same lines, which are parsed here:
+- timings, e.g. `Exp: 0.1 s` or `  Done in 0.1 s`;
+- checks, e.g. `Checksum: 123.4` or `  histogram(c) = 1 2 3`.
+"""
+
+from argparse import ArgumentParser
+import itertools
+import math
+import os
+import re
+import subprocess
+import sys
+
+
+BENCHMARKS = {
+    "exp": {
+        "cpp": "KokkosBenchmarkExp",
+        "py": "NumpyBenchmarkExp.py",
+        "sweep": {"side": [1024, 2048, 4096]},
+        "timings": {"exp": r"^Exp: (\S+) s"},
+        "checks": {"checksum": r"^Checksum: (\S+)"},
+    },
+    "iteration": {
+        "cpp": "KokkosBenchmarkIteration",
+        "py": "NumpyBenchmarkIteration.py",
+        "sweep": {"side": [100, 200, 400]},
+        "timings": {"add": r"^Add: (\S+) s", "sum": r"^Sum: (\S+) s", "histogram": r"^Histogram: (\S+) s"},
+        "checks": {"sum": r"^Sum: \S+ s \((\S+)\)", "histogram": r"= ([\d ]+)"},
+    },
+    "convolution": {
+        "cpp": "KokkosBenchmarkConvolution",
+        "py": "NumpyBenchmarkConvolution.py",
+        "sweep": {"image": [512, 1024, 2048], "kernel": [3, 5, 7]},
+        "timings": {"correlate": r"Done in (\S+) s"},
+        "checks": {"checksum": r"^Checksum: (\S+)"},
+    },
+    "median": {
+        "cpp": "KokkosBenchmarkMedian",
+        "py": "NumpyBenchmarkMedian.py",
+        # Even kernels are excluded: SciPy returns the upper median instead of the mean of both middle values
+        "sweep": {"image": [512, 1024, 2048], "kernel": [3, 5], "filter": ["median", "min", "max"]},
+        "timings": {"filter": r"Done in (\S+) s"},
+        "checks": {"checksum": r"^Checksum: (\S+)"},
+    },
+}
+
+
+def run(command):
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"{' '.join(command)} failed:\n{result.stderr}")
+    return result.stdout
+
+
+def parse(output, patterns):
+    values = {}
+    for name, pattern in patterns.items():
+        match = re.search(pattern, output, re.MULTILINE)
+        if match is None:
+            raise RuntimeError(f"Cannot find {name} in output:\n{output}")
+        values[name] = match.group(1)
+    return values
+
+
+def agree(lhs, rhs, tolerance):
+    lhs_values = [float(v) for v in lhs.split()]
+    rhs_values = [float(v) for v in rhs.split()]
+    if len(lhs_values) != len(rhs_values):
+        return False
+    return all(l == r or math.isclose(l, r, rel_tol=tolerance) for l, r in zip(lhs_values, rhs_values))
+
+
+if __name__ == "__main__":
+
+    parser = ArgumentParser(description="Compare Linx benchmarks with NumPy/SciPy references")
+    parser.add_argument("--build", type=str, default="build", help="The directory of the C++ executables")
+    parser.add_argument("--benchmarks", nargs="+", default=list(BENCHMARKS), choices=list(BENCHMARKS))
+    parser.add_argument("--tolerance", type=float, default=1e-4, help="The relative tolerance of the checks")
+    args = parser.parse_args()
+
+    here = os.path.dirname(os.path.abspath(__file__))
+    failures = 0
+
+    print(f"{'Benchmark':<14}{'Parameters':<36}{'Timing':<12}{'Linx (s)':>12}{'NumPy (s)':>12}{'Speedup':>10}  Check")
+    for name in args.benchmarks:
+        benchmark = BENCHMARKS[name]
+        keys = list(benchmark["sweep"])
+        for values in itertools.product(*benchmark["sweep"].values()):
+            options = list(itertools.chain(*[[f"--{k}", str(v)] for k, v in zip(keys, values)]))
+            cpp = run([os.path.join(args.build, benchmark["cpp"])] + options)
+            py = run([sys.executable, os.path.join(here, benchmark["py"])] + options)
+
+            cpp_checks = parse(cpp, benchmark["checks"])
+            py_checks = parse(py, benchmark["checks"])
+            ok = all(agree(cpp_checks[c], py_checks[c], args.tolerance) for c in cpp_checks)
+            if not ok:
+                failures += 1
+                print(f"  Mismatch: {cpp_checks} != {py_checks}")
+
+            cpp_timings = parse(cpp, benchmark["timings"])
+            py_timings = parse(py, benchmark["timings"])
+            parameters = " ".join(f"{k}={v}" for k, v in zip(keys, values))
+            for timing in benchmark["timings"]:
+                cpp_time = float(cpp_timings[timing])
+                py_time = float(py_timings[timing])
+                speedup = py_time / cpp_time if cpp_time > 0 else math.inf
+                print(
+                    f"{name:<14}{parameters:<36}{timing:<12}{cpp_time:>12.4g}{py_time:>12.4g}{speedup:>10.2f}  "
+                    f"{'OK' if ok else 'FAILED'}"
+                )
+
+    if failures:
+        print(f"\n{failures} mismatch(es)")
+        sys.exit(1)
@@ -5,11 +5,8 @@ import time
 
 
 def make_2d(side):
-    image = np.empty([side, side], dtype=int)
-    for i in range(image.shape[0]):
-        for j in range(image.shape[1]):
-            image[i, j] = i+j
-    return image
+    index = np.arange(side)
+    return np.add.outer(index, index)
 
 
 def print_2d(name, image):
@@ -44,3 +41,4 @@ if __name__ == "__main__":
         stop = time.perf_counter()
     print(f"  Done in {stop-start} s")
     print_2d("output", output)
+    print(f"Checksum: {np.sum(output, dtype=np.float64)}")
@@ -0,0 +1,22 @@
+from argparse import ArgumentParser
+import numpy as np
+import time
+
+
+if __name__ == "__main__":
+
+    parser = ArgumentParser(description="Compute the exponential")
+    parser.add_argument("--side", type=int, default=4096, help="The side of the square image")
+    args = parser.parse_args()
+
+    start = time.perf_counter()
+    index = np.arange(args.side, dtype=np.float32)
+    a = np.subtract.outer(index, index).T / np.float32(args.side)  # a[j, i] = (j - i) / side
+    stop = time.perf_counter()
+    print(f"Init: {stop-start} s")
+
+    start = time.perf_counter()
+    np.exp(a, out=a)
+    stop = time.perf_counter()
+    print(f"Exp: {stop-start} s")
+    print(f"Checksum: {np.sum(a, dtype=np.float64)}")
@@ -0,0 +1,38 @@
+from argparse import ArgumentParser
+import numpy as np
+import time
+
+
+if __name__ == "__main__":
+
+    parser = ArgumentParser(description="Sum two images")
+    parser.add_argument("--side", type=int, default=400, help="The side of the cubic image")
+    args = parser.parse_args()
+    shape = (args.side, args.side, args.side)
+
+    start = time.perf_counter()
+    index = np.arange(args.side, dtype=np.int64)
+    a = np.empty(shape, dtype=np.int64)
+    b = np.empty(shape, dtype=np.int64)
+    a[...] = index  # a[k, j, i] = i
+    b[...] = 2 * index
+    stop = time.perf_counter()
+    print(f"Init: {stop-start} s")
+
+    start = time.perf_counter()
+    c = np.add(a, b)
+    stop = time.perf_counter()
+    print(f"Add: {stop-start} s")
+
+    start = time.perf_counter()
+    sum = np.sum(c)
+    stop = time.perf_counter()
+    print(f"Sum: {stop-start} s ({sum})")
+
+    bins = [0, 1, 10, 100, 1000]
+    start = time.perf_counter()
+    hist, _ = np.histogram(c, bins)
+    hist[-1] -= np.count_nonzero(c == bins[-1])  # Linx bins are all half-open
+    stop = time.perf_counter()
+    print(f"Histogram: {stop-start} s")
+    print(f"  histogram(c) = {' '.join(str(h) for h in hist)} ")
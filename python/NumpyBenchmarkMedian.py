@@ -0,0 +1,42 @@
+from argparse import ArgumentParser
+import numpy as np
+from scipy import ndimage
+import time
+
+
+def make_2d(side):
+    index = np.arange(side)
+    return np.add.outer(index, index).astype(np.float32)
+
+
+def print_2d(name, image):
+    print(f"{name}:")
+    print(f"  {image.shape[1]} x {image.shape[0]}")
+    print(f"  [{image[0,0]}, ... , {image[-1,-1]}]")
+
+
+if __name__ == "__main__":
+
+    parser = ArgumentParser()
+    parser.add_argument("--image", type=int, default=2048, help="Input length along each axis")
+    parser.add_argument("--kernel", type=int, default=5, help="Kernel length along each axis")
+    parser.add_argument("--filter", type=str, default="median", choices=["median", "min", "max"])
+    args = parser.parse_args()
+
+    print("Generating input and kernel...")
+    input = make_2d(args.image)
+    print_2d("input", input)
+    print("kernel:")
+    print(f"  {args.kernel} x {args.kernel}")
+
+    filters = {"median": ndimage.median_filter, "min": ndimage.minimum_filter, "max": ndimage.maximum_filter}
+    center = args.kernel // 2  # The window is [i - center, i - center + kernel) along each axis
+    side = args.image - args.kernel + 1
+
+    print("Filtering...")
+    start = time.perf_counter()
+    output = filters[args.filter](input, size=args.kernel)[center:center+side, center:center+side]
+    stop = time.perf_counter()
+    print(f"  Done in {stop-start} s")
+    print_2d("output", output)
+    print(f"Checksum: {np.sum(output, dtype=np.float64)}")
@@ -8,6 +8,7 @@
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Timer.hpp>
+#include <iomanip>
 
 void print_2d(const auto& image)
 {
@@ -53,6 +54,7 @@ int main(int argc, char const* argv[])
 
   std::cout << "  Done in " << elapsed << " s" << std::endl;
   print_2d(output);
+  std::cout << "Checksum: " << std::setprecision(10) << Linx::sum(output) << std::endl;
 
   return 0;
 }
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Kokkos_Timer.hpp"
+#include "Linx/Data/Image.h"
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Correlation.h"
+#include "Linx/Transforms/RankFiltering.h"
+
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+
+/**
+ * @brief The best time over a number of runs, after one warm-up run.
+ */
+double best_of(int repeat, auto&& func)
+{
+  func();
+  Kokkos::fence();
+  double best = std::numeric_limits<double>::max();
+  Kokkos::Timer timer;
+  for (int r = 0; r < repeat; ++r) {
+    timer.reset();
+    func();
+    Kokkos::fence();
+    best = std::min(best, timer.seconds());
+  }
+  return best;
+}
+
+/**
+ * @brief Time each operation family on 3D images of static rank 3 or dynamic rank.
+ */
+template <int N>
+std::map<std::string, double> run(int side, int repeat)
+{
+  Linx::Image<float, N> a("a", side, side, side);
+  Linx::Image<float, N> b("b", side, side, side);
+  Linx::Image<float, N> c("c", side, side, side);
+  Linx::Image<float, N> kernel("kernel", 3, 3, 3);
+  kernel.fill(1. / kernel.size());
+  const auto domain = a.domain();
+  float checksum = 0;
+
+  // Element-wise lambdas index the images directly, i.e. without the fast path
+  const auto init = KOKKOS_LAMBDA(int i, int j, int k)
+  {
+    a(i, j, k) = i + j;
+    b(i, j, k) = j - k;
+  };
+  const auto multiply_add = KOKKOS_LAMBDA(float a_i, float b_i)
+  {
+    return a_i * b_i + 1;
+  };
+  const auto half = KOKKOS_LAMBDA(float c_i)
+  {
+    return c_i * 0.5f;
+  };
+
+  std::map<std::string, double> out;
+  out["for_each"] = best_of(repeat, [&] {
+    Linx::for_each("for_each", domain, init);
+  });
+  out["fill_with_offsets"] = best_of(repeat, [&] {
+    c.fill_with_offsets();
+  });
+  out["generate"] = best_of(repeat, [&] {
+    c.generate("generate", multiply_add, a, b);
+  });
+  out["apply"] = best_of(repeat, [&] {
+    c.apply("apply", half);
+  });
+  out["arithmetic"] = best_of(repeat, [&] {
+    c += a;
+  });
+  out["copy"] = best_of(repeat, [&] {
+    c.copy_from(a);
+  });
+  out["sum"] = best_of(repeat, [&] {
+    checksum += Linx::sum(a);
+  });
+  out["dot"] = best_of(repeat, [&] {
+    checksum += Linx::dot(a, b);
+  });
+  out["contains"] = best_of(repeat, [&] {
+    checksum += a.contains(-1);
+  });
+
+  // Filters index their input through precomputed offsets, from the element of the output position
+  out["correlate"] = best_of(repeat, [&] {
+    Linx::correlate("correlate", a, kernel);
+  });
+  out["median_filter"] = best_of(repeat, [&] {
+    Linx::median_filter("median_filter", 1, a);
+  });
+  std::cout << "  Checksum (rank " << N << "): " << checksum << std::endl;
+  return out;
+}
+
+int main(int argc, const char* argv[])
+{
+  Linx::ProgramContext context("Compare static-rank and dynamic-rank images", argc, argv);
+  context.named("side", "The side of the cubic images", 256);
+  context.named("repeat", "The number of timed runs, the best of which is kept", 5);
+  context.parse();
+  const auto side = context.as<int>("side");
+  const auto repeat = context.as<int>("repeat");
+
+  const auto fixed = run<3>(side, repeat);
+  const auto dynamic = run<-1>(side, repeat);
+
+  std::cout << "\n"
+            << std::left << std::setw(22) << "  Operation" << std::right << std::setw(14) << "Rank 3 (s)"
+            << std::setw(14) << "Rank -1 (s)" << std::setw(10) << "Ratio"
+            << "\n";
+  for (const auto& [name, seconds] : fixed) {
+    const auto dynamic_seconds = dynamic.at(name);
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::scientific << std::setprecision(3)
+              << std::setw(14) << seconds << std::setw(14) << dynamic_seconds << std::fixed << std::setprecision(2)
+              << std::setw(10) << dynamic_seconds / seconds << "\n";
+  }
+
+  return 0;
+}
@@ -2,6 +2,7 @@
 #include "Linx/Data/Image.h"
 #include "Linx/Run/ProgramContext.h"
 
+#include <iomanip>
 #include <iostream>
 
 int main(int argc, const char* argv[])
@@ -16,7 +17,7 @@ int main(int argc, const char* argv[])
   for_each(
       "init",
       a.domain(),
-      KOKKOS_LAMBDA(int i, int j) { a(i, j) = j - i; });
+      KOKKOS_LAMBDA(int i, int j) { a(i, j) = float(j - i) / side; });
   Kokkos::fence();
   auto init_time = timer.seconds();
   std::cout << "Init: " << init_time << " s" << std::endl;
@@ -28,6 +29,7 @@ int main(int argc, const char* argv[])
   Kokkos::fence();
   auto exp_time = timer.seconds();
   std::cout << "Exp: " << exp_time << " s" << std::endl;
+  std::cout << "Checksum: " << std::setprecision(10) << Linx::sum(a) << std::endl;
 
   return 0;
 }
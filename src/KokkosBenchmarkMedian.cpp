@@ -8,6 +8,7 @@
 
 #include <Kokkos_Core.hpp>
 #include <Kokkos_Timer.hpp>
+#include <iomanip>
 
 void print_2d(const auto& image)
 {
@@ -26,11 +27,13 @@ int main(int argc, char const* argv[])
   Linx::ProgramContext context("", argc, argv);
   context.named("image", "Input length along each axis", 2048);
   context.named("kernel", "Kernel length along each axis", 5);
+  context.named("filter", "Filter type: median, min or max", std::string("median"));
   context.flag("parity", "Enable parity tag");
   context.parse();
   const auto image_diameter = context.as<int>("image");
   const auto kernel_diameter = context.as<int>("kernel");
   const auto kernel_parity = context.as<bool>("parity");
+  const auto filter = context.as<std::string>("filter");
   const auto output_diameter = image_diameter - kernel_diameter + 1;
 
   std::cout << "Generating input and kernel..." << std::endl;
@@ -48,7 +51,11 @@ int main(int argc, char const* argv[])
   std::cout << "Filtering..." << std::endl;
   Kokkos::Timer timer;
   auto output = Linx::Image<float, 2>("output", output_diameter, output_diameter);
-  if (kernel_parity) {
+  if (filter == "min") {
+    output.copy_from(Linx::MinFilter(kernel, image));
+  } else if (filter == "max") {
+    output.copy_from(Linx::MaxFilter(kernel, image));
+  } else if (kernel_parity) {
     Linx::median_filter_to(kernel, image, output); // Parity tag is inferred from kernel
   } else {
     output.copy_from(Linx::MedianFilter(kernel, image)); // Unknown parity
@@ -58,6 +65,7 @@ int main(int argc, char const* argv[])
 
   std::cout << "  Done in " << elapsed << " s" << std::endl;
   print_2d(output);
+  std::cout << "Checksum: " << std::setprecision(10) << Linx::sum(output) << std::endl;
 
   return 0;
 }
@@ -0,0 +1,309 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Kokkos_Timer.hpp"
+#include "Linx/Base/Algorithm.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Correlation.h"
+#include "Linx/Transforms/RankFiltering.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief A measurement, with its traffic and operation models.
+ *
+ * Bytes are the compulsory traffic (each input read once, each output written once),
+ * such that the achieved bandwidth is a lower bound of the actual one.
+ * Operations are floating point operations, or comparisons for rank filters.
+ */
+struct Record {
+  std::string family;
+  long side;
+  double seconds;
+  double bytes;
+  double ops;
+
+  double bandwidth() const
+  {
+    return bytes / seconds * 1.e-9;
+  }
+
+  double throughput() const
+  {
+    return ops / seconds * 1.e-9;
+  }
+
+  double intensity() const
+  {
+    return ops / bytes;
+  }
+};
+
+/**
+ * @brief The best time over a number of runs, after one warm-up run.
+ */
+double best_of(int repeat, auto&& func)
+{
+  func();
+  Kokkos::fence();
+  double best = std::numeric_limits<double>::max();
+  Kokkos::Timer timer;
+  for (int r = 0; r < repeat; ++r) {
+    timer.reset();
+    func();
+    Kokkos::fence();
+    best = std::min(best, timer.seconds());
+  }
+  return best;
+}
+
+/**
+ * @brief STREAM-like copy, scale, add and triad kernels, written with `for_each`.
+ */
+std::vector<Record> measure_bandwidth(long size, int repeat)
+{
+  Linx::Image<float, 1> a("a", size);
+  Linx::Image<float, 1> b("b", size);
+  Linx::Image<float, 1> c("c", size);
+  const auto domain = a.domain();
+  const float s = 3;
+  Linx::for_each(
+      "init",
+      domain,
+      KOKKOS_LAMBDA(int i) {
+        a(i) = 1;
+        b(i) = 2;
+        c(i) = 0;
+      });
+
+  // Kernels are defined out of the timed host lambdas, which device compilers forbid to enclose them
+  const auto copy = KOKKOS_LAMBDA(int i)
+  {
+    c(i) = a(i);
+  };
+  const auto scale = KOKKOS_LAMBDA(int i)
+  {
+    b(i) = s * c(i);
+  };
+  const auto add = KOKKOS_LAMBDA(int i)
+  {
+    c(i) = a(i) + b(i);
+  };
+  const auto triad = KOKKOS_LAMBDA(int i)
+  {
+    a(i) = b(i) + s * c(i);
+  };
+
+  const double n = size * sizeof(float);
+  std::vector<Record> out;
+  out.push_back({"copy", size, best_of(repeat, [&] { Linx::for_each("copy", domain, copy); }), 2 * n, 0});
+  out.push_back({"scale", size, best_of(repeat, [&] { Linx::for_each("scale", domain, scale); }), 2 * n, 1. * size});
+  out.push_back({"add", size, best_of(repeat, [&] { Linx::for_each("add", domain, add); }), 3 * n, 1. * size});
+  out.push_back({"triad", size, best_of(repeat, [&] { Linx::for_each("triad", domain, triad); }), 3 * n, 2. * size});
+  return out;
+}
+
+/**
+ * @brief Compute-bound kernel made of independent chains of multiply-adds kept in registers.
+ */
+Record measure_flops(long size, int repeat)
+{
+  constexpr int Chains = 8;
+  constexpr int Iterations = 256;
+  Linx::Image<float, 1> a("a", size);
+  const auto domain = a.domain();
+  const auto fma = KOKKOS_LAMBDA(int i)
+  {
+    float x[Chains];
+    for (int c = 0; c < Chains; ++c) {
+      x[c] = i + c;
+    }
+    for (int k = 0; k < Iterations; ++k) {
+      for (int c = 0; c < Chains; ++c) {
+        x[c] = x[c] * 0.999f + 0.001f;
+      }
+    }
+    float sum = 0;
+    for (int c = 0; c < Chains; ++c) {
+      sum += x[c];
+    }
+    a(i) = sum;
+  };
+  const auto seconds = best_of(repeat, [&] {
+    Linx::for_each("fma", domain, fma);
+  });
+  return {"fma", size, seconds, double(size * sizeof(float)), 2. * Chains * Iterations * size};
+}
+
+/**
+ * @brief The number of comparisons of `Linx::median()` for an odd array size, following `select_n()`.
+ *
+ * This is the worst case of the insertion sort for small arrays,
+ * the exact number of compare-exchanges of the sorting network for medium arrays (e.g. 25 taps),
+ * and the expected number of comparisons of introselect, about 3.4 times the size, for large arrays.
+ */
+double median_comparisons(std::size_t size)
+{
+  if (size <= Linx::Impl::select_insertion_max) {
+    return size * (size - 1) / 2.;
+  }
+  if (size > Linx::Impl::select_network_max) {
+    return 3.4 * size;
+  }
+  double out = 0; // Same loops as Impl::network_sort()
+  for (std::size_t p = 1; p < size; p <<= 1) {
+    for (std::size_t k = p; k >= 1; k >>= 1) {
+      for (std::size_t j = k % p; j + k < size; j += 2 * k) {
+        for (std::size_t i = 0; i < k && i + j + k < size; ++i) {
+          out += (i + j) / (2 * p) == (i + j + k) / (2 * p);
+        }
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * @brief Run the Linx kernel families on square images of given side.
+ */
+std::vector<Record> measure_families(long side, Linx::Index radius, int repeat)
+{
+  Linx::Image<float, 2> a("a", side, side);
+  Linx::Image<float, 2> b("b", side, side);
+  Linx::Image<float, 2> c("c", side, side);
+  const auto diameter = 2 * radius + 1;
+  Linx::Image<float, 2> kernel("kernel", diameter, diameter);
+  Linx::for_each(
+      "init",
+      a.domain(),
+      KOKKOS_LAMBDA(int i, int j) {
+        a(i, j) = i + j;
+        b(i, j) = i - j;
+      });
+  kernel.fill(1. / (diameter * diameter));
+
+  const double n = a.size();
+  const double m = double(side - diameter + 1) * (side - diameter + 1);
+  const double taps = diameter * diameter;
+  const double bytes = sizeof(float);
+  [[maybe_unused]] float sum = 0; // Prevents the reduction from being optimized out
+
+  const auto multiply_add = KOKKOS_LAMBDA(float a_i, float b_i)
+  {
+    return a_i * b_i + 1;
+  };
+  const auto half_add = KOKKOS_LAMBDA(float c_i)
+  {
+    return c_i * 0.5f + 1;
+  };
+
+  std::vector<Record> out;
+  out.push_back(
+      {"generate", side, best_of(repeat, [&] { c.generate("generate", multiply_add, a, b); }), 3 * n * bytes, 2 * n});
+  out.push_back({"apply", side, best_of(repeat, [&] { c.apply("apply", half_add); }), 2 * n * bytes, 2 * n});
+  out.push_back({"sum", side, best_of(repeat, [&] { sum += Linx::sum(a); }), n * bytes, n});
+  out.push_back(
+      {"correlate",
+       side,
+       best_of(repeat, [&] { Linx::correlate("correlate", a, kernel); }),
+       (n + m) * bytes,
+       2 * taps * m});
+  out.push_back(
+      {"median_filter",
+       side,
+       best_of(repeat, [&] { Linx::median_filter("median_filter", radius, a); }),
+       (n + m) * bytes,
+       median_comparisons(diameter * diameter) * m});
+  return out;
+}
+
+int main(int argc, const char* argv[])
+{
+  Linx::ProgramContext context("Characterize Linx kernels against measured bandwidth and FLOP ceilings", argc, argv);
+  context.named("stream", "The number of elements of the STREAM-like arrays", 1L << 25);
+  context.named("min", "The minimum side of the square images", 256L);
+  context.named("max", "The maximum side of the square images", 4096L);
+  context.named("radius", "The radius of the correlation kernel and median filter", 2L);
+  context.named("repeat", "The number of timed runs, the best of which is kept", 5);
+  context.named("json", "The output JSON file", std::string("roofline.json"));
+  context.parse();
+  const auto repeat = context.as<int>("repeat");
+  const auto radius = context.as<long>("radius");
+
+  std::cout << std::fixed << std::setprecision(3);
+
+  std::cout << "\nCeilings:\n\n";
+  auto ceilings = measure_bandwidth(context.as<long>("stream"), repeat);
+  ceilings.push_back(measure_flops(context.as<long>("stream"), repeat));
+  double peak_bandwidth = 0;
+  for (const auto& r : ceilings) {
+    if (r.family != "fma") {
+      peak_bandwidth = std::max(peak_bandwidth, r.bandwidth());
+    }
+  }
+  const auto peak_throughput = ceilings.back().throughput();
+  std::cout << std::left << std::setw(16) << "  Kernel" << std::right << std::setw(12) << "Time (s)" << std::setw(12)
+            << "GB/s" << std::setw(12) << "GFLOP/s"
+            << "\n";
+  for (const auto& r : ceilings) {
+    std::cout << "  " << std::left << std::setw(14) << r.family << std::right << std::setw(12) << r.seconds
+              << std::setw(12) << r.bandwidth() << std::setw(12) << r.throughput() << "\n";
+  }
+  std::cout << "\n  Peak bandwidth: " << peak_bandwidth << " GB/s\n";
+  std::cout << "  Peak throughput: " << peak_throughput << " GFLOP/s\n";
+  std::cout << "  Ridge point: " << peak_throughput / peak_bandwidth << " FLOP/B\n";
+
+  std::vector<Record> records;
+  for (auto side = context.as<long>("min"); side <= context.as<long>("max"); side *= 2) {
+    const auto family_records = measure_families(side, radius, repeat);
+    records.insert(records.end(), family_records.begin(), family_records.end());
+  }
+
+  std::cout << "\nKernels:\n\n";
+  std::cout << std::left << std::setw(16) << "  Family" << std::right << std::setw(8) << "Side" << std::setw(12)
+            << "Time (s)" << std::setw(12) << "GB/s" << std::setw(12) << "GOP/s" << std::setw(12) << "OP/B"
+            << std::setw(10) << "% BW" << std::setw(10) << "% roof"
+            << "\n";
+  for (const auto& r : records) {
+    const auto roof = std::min(peak_throughput, r.intensity() * peak_bandwidth);
+    std::cout << "  " << std::left << std::setw(14) << r.family << std::right << std::setw(8) << r.side
+              << std::setw(12) << r.seconds << std::setw(12) << r.bandwidth() << std::setw(12) << r.throughput()
+              << std::setw(12) << r.intensity() << std::setw(10) << 100 * r.bandwidth() / peak_bandwidth
+              << std::setw(10) << 100 * r.throughput() / roof << "\n";
+  }
+
+  const auto filename = context.as<std::string>("json");
+  std::ofstream json(filename);
+  json << std::setprecision(6);
+  json << "{\n  \"execution_space\": \"" << Kokkos::DefaultExecutionSpace::name() << "\",\n";
+  json << "  \"peak_bandwidth_gbps\": " << peak_bandwidth << ",\n";
+  json << "  \"peak_gflops\": " << peak_throughput << ",\n";
+  json << "  \"ceilings\": [";
+  for (std::size_t i = 0; i < ceilings.size(); ++i) {
+    const auto& r = ceilings[i];
+    json << (i ? ",\n" : "\n") << "    {\"kernel\": \"" << r.family << "\", \"size\": " << r.side
+         << ", \"seconds\": " << r.seconds << ", \"gbps\": " << r.bandwidth() << ", \"gflops\": " << r.throughput()
+         << "}";
+  }
+  json << "\n  ],\n  \"kernels\": [";
+  for (std::size_t i = 0; i < records.size(); ++i) {
+    const auto& r = records[i];
+    const auto roof = std::min(peak_throughput, r.intensity() * peak_bandwidth);
+    json << (i ? ",\n" : "\n") << "    {\"family\": \"" << r.family << "\", \"side\": " << r.side
+         << ", \"seconds\": " << r.seconds << ", \"bytes\": " << r.bytes << ", \"ops\": " << r.ops
+         << ", \"gbps\": " << r.bandwidth() << ", \"gops\": " << r.throughput() << ", \"intensity\": " << r.intensity()
+         << ", \"bandwidth_fraction\": " << r.bandwidth() / peak_bandwidth
+         << ", \"roof_fraction\": " << r.throughput() / roof << "}";
+  }
+  json << "\n  ]\n}\n";
+  std::cout << "\nResults written to: " << filename << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Kokkos_Timer.hpp"
+#include "Linx/Base/Algorithm.h"
+#include "Linx/Base/ArrayPool.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Compute the median of many pseudo-random arrays of size `n`, with `sort_n()` or `select_n()`.
+ * @return The elapsed time and the sum of the medians
+ */
+template <bool Adaptive>
+std::pair<double, double> run(int count, int n)
+{
+  Linx::ArrayPool<float> pool(n);
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  double checksum = 0;
+  Kokkos::parallel_reduce(
+      Adaptive ? "select_n()" : "sort_n()",
+      count,
+      KOKKOS_LAMBDA(int k, double& sum) {
+        auto array = pool.array();
+        unsigned state = 2654435761U * (k + 1);
+        for (std::size_t i = 0; i < array.size(); ++i) {
+          state = state * 1664525U + 1013904223U;
+          array[i] = state >> 8;
+        }
+        if constexpr (Adaptive) {
+          sum += Linx::select_n(array, n / 2);
+        } else {
+          sum += Linx::sort_n(array, n / 2);
+        }
+      },
+      checksum);
+  Kokkos::fence();
+  return {timer.seconds(), checksum};
+}
+
+int main(int argc, const char* argv[])
+{
+  Linx::ProgramContext context("Compare sort_n() and select_n() for increasing array sizes", argc, argv);
+  context.named("count", "The number of arrays", 1 << 16);
+  context.named("max", "The maximum array size", 343);
+  context.parse();
+  const auto count = context.as<int>("count");
+  const auto max = context.as<int>("max");
+
+  std::cout << std::setw(8) << "n" << std::setw(14) << "sort_n (s)" << std::setw(14) << "select_n (s)"
+            << std::setw(10) << "Speedup"
+            << "  Check\n";
+  for (int n : {3, 5, 8, 9, 16, 25, 32, 33, 49, 81, 121, 169, 343, 729}) {
+    if (n > max) {
+      break;
+    }
+    const auto [sort_time, sort_sum] = run<false>(count, n);
+    const auto [select_time, select_sum] = run<true>(count, n);
+    std::cout << std::setw(8) << n << std::scientific << std::setprecision(3) << std::setw(14) << sort_time
+              << std::setw(14) << select_time << std::fixed << std::setprecision(2) << std::setw(10)
+              << sort_time / select_time << "  " << (sort_sum == select_sum ? "OK" : "MISMATCH") << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-PackageSourceInfo: https://github.com/kabasset/KokkosTest
+// SPDX-License-Identifier: Apache-2.0
+
+#include "Kokkos_Timer.hpp"
+#include "Linx/Data/Sorting.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Sort pseudo-random values with Linx and with `std::sort()`.
+ */
+template <typename T>
+void run(Linx::Index size)
+{
+  Linx::Sequence<T, -1> a("a", size);
+  a.fill_with_offsets();
+  a.apply(
+      "scramble",
+      KOKKOS_LAMBDA(T e) { return T((static_cast<long long>(e) * 2654435761LL) % 1000003 - 500000); });
+  auto on_host = Linx::on_host(a);
+  std::vector<T> expected(on_host.data(), on_host.data() + size);
+  Kokkos::fence();
+
+  Kokkos::Timer timer;
+  Linx::sort(a);
+  Kokkos::fence();
+  const auto linx_time = timer.seconds();
+
+  timer.reset();
+  std::sort(expected.begin(), expected.end());
+  const auto std_time = timer.seconds();
+
+  on_host = Linx::on_host(a);
+  const bool ok = std::equal(expected.begin(), expected.end(), on_host.data());
+  std::cout << "Sort: " << linx_time << " s" << std::endl;
+  std::cout << "std::sort: " << std_time << " s" << std::endl;
+  std::cout << "Speedup: " << std_time / linx_time << (ok ? "" : " (MISMATCH)") << std::endl;
+
+  Linx::Sequence<T, -1> b("b", size);
+  b.fill_with_offsets();
+  b.reverse();
+  timer.reset();
+  const auto indices = Linx::argsort(b);
+  Kokkos::fence();
+  std::cout << "Argsort: " << timer.seconds() << " s" << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+  Linx::ProgramContext context("Compare the parallel radix sort with std::sort()", argc, argv);
+  context.named("size", "The number of elements", 10'000'000);
+  context.named("type", "The value type: int, float or double", std::string("float"));
+  context.parse();
+  const auto size = context.as<int>("size");
+  const auto type = context.as<std::string>("type");
+
+  if (type == "int") {
+    run<int>(size);
+  } else if (type == "float") {
+    run<float>(size);
+  } else if (type == "double") {
+    run<double>(size);
+  } else {
+    std::cerr << "Unknown type: " << type << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -7,8 +7,10 @@
 #include "Linx/Data/Sequence.h"
 #include "Linx/Run/ProgramContext.h"
 
+#include <algorithm>
 #include <boost/test/unit_test.hpp>
 #include <ranges>
+#include <vector>
 
 LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -44,10 +46,50 @@ BOOST_AUTO_TEST_CASE(even_random_test)
   BOOST_TEST(Linx::sort_n(a, 1) == 1);
   BOOST_TEST(not std::ranges::is_sorted(a));
   BOOST_TEST(std::ranges::is_sorted_until(a.data(), a.data() + 2));
-  BOOST_TEST(Linx::median(a) == 550);
+  BOOST_TEST(Linx::median(a) == 55); // Mean of 10 and 100
   BOOST_TEST(std::ranges::is_sorted_until(a.data(), a.data() + 4));
   BOOST_TEST(Linx::sort_n(a, 5));
   BOOST_TEST(std::ranges::is_sorted(a));
 }
 
+BOOST_AUTO_TEST_CASE(select_sweep_test)
+{
+  for (int size : {1, 2, 5, 8, 9, 16, 25, 32, 33, 49, 121, 343, 1000}) {
+    std::vector<int> values(size);
+    for (int i = 0; i < size; ++i) {
+      values[i] = (i * 7919) % 101 - 50; // With duplicates
+    }
+    auto sorted = values;
+    std::ranges::sort(sorted);
+    for (int n : {0, size / 2, size - 1}) {
+      auto a = values;
+      BOOST_TEST(Linx::select_n(a, n) == sorted[n]);
+      BOOST_TEST(std::all_of(a.begin(), a.begin() + n, [&](int e) {
+        return e <= sorted[n];
+      }));
+      BOOST_TEST(std::all_of(a.begin() + n, a.end(), [&](int e) {
+        return e >= sorted[n];
+      }));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(large_median_test)
+{
+  for (int size : {49, 121, 343}) {
+    std::vector<double> values(size);
+    for (int i = 0; i < size; ++i) {
+      values[i] = size - i;
+    }
+    BOOST_TEST(Linx::median(values) == size / 2 + 1);
+  }
+  std::vector<double> even(100);
+  for (int i = 0; i < 100; ++i) {
+    even[i] = 100 - i;
+  }
+  BOOST_TEST(Linx::median(even) == 50.5);
+  std::vector<double> small {4, 1, 3, 2};
+  BOOST_TEST(Linx::median(small) == 2.5);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
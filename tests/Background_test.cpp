@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE BackgroundTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Background.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(flat_background_with_sources_test)
+{
+  const int width = 256;
+  const int height = 192;
+  Linx::Image<float, 2> image("image", width, height);
+  Linx::for_each(
+      "sky",
+      image.domain(),
+      KOKKOS_LAMBDA(int x, int y) {
+        const bool star = (x % 37 == 5) && (y % 29 == 3);
+        image(x, y) = star ? 10000.F : 100.F + float((x * 7 + y * 13) % 3 - 1);
+      });
+  const auto out = Linx::estimate_background(image, Linx::Position<2> {64, 64});
+  BOOST_TEST(out.mesh.extent(0) == 4);
+  BOOST_TEST(out.mesh.extent(1) == 3);
+
+  const auto background = Linx::on_host(out.background);
+  const auto rms = Linx::on_host(out.rms);
+  const auto subtracted = Linx::on_host(out.subtracted);
+  const auto image_on_host = Linx::on_host(image);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      BOOST_TEST(std::abs(background(x, y) - 100.F) < 0.5F);
+      BOOST_TEST(rms(x, y) < 1.F);
+      BOOST_TEST(subtracted(x, y) == image_on_host(x, y) - background(x, y));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(linear_background_test)
+{
+  const int cell = 63;
+  const int width = 5 * cell;
+  const int height = 5 * cell;
+  Linx::Image<float, 2> image("image", width, height);
+  Linx::for_each(
+      "ramp",
+      image.domain(),
+      KOKKOS_LAMBDA(int x, int y) { image(x, y) = 0.1F * x + 0.2F * y; });
+  Linx::BackgroundParameters parameters;
+  parameters.filter_radius = 0;
+  const auto out = Linx::estimate_background(image, Linx::Position<2> {cell, cell}, parameters);
+  const auto background = Linx::on_host(out.background);
+  // Linear functions are reproduced where the interpolation stencil does not reach the mesh borders
+  for (int y = cell + cell / 2; y <= height - cell - cell / 2 - 1; ++y) {
+    for (int x = cell + cell / 2; x <= width - cell - cell / 2 - 1; ++x) {
+      BOOST_TEST(background(x, y) == 0.1F * x + 0.2F * y, boost::test_tools::tolerance(1e-4F));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE BinningTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Binning.h"
+
+#include <boost/test/unit_test.hpp>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(bin_test)
+{
+  const int width = 7;
+  const int height = 4;
+  Linx::Image<int, 2> in("in", width, height);
+  Linx::for_each(
+      "ramp",
+      in.domain(),
+      KOKKOS_LAMBDA(int i, int j) { in(i, j) = i + width * j; });
+
+  const auto out = Linx::bin(in, Linx::Position<2> {3, 2});
+
+  BOOST_TEST(out.extent(0) == 2);
+  BOOST_TEST(out.extent(1) == 2);
+  const auto in_on_host = Linx::on_host(in);
+  const auto out_on_host = Linx::on_host(out);
+  for (int v = 0; v < 2; ++v) {
+    for (int u = 0; u < 2; ++u) {
+      int expected = 0;
+      for (int j = 2 * v; j < 2 * v + 2; ++j) {
+        for (int i = 3 * u; i < 3 * u + 3; ++i) {
+          expected += in_on_host(i, j);
+        }
+      }
+      BOOST_TEST(out_on_host(u, v) == expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bin_variance_test)
+{
+  const int width = 6;
+  const int height = 6;
+  Linx::Image<float, 2> in("in", width, height);
+  Linx::Image<float, 2> variance("variance", width, height);
+  in.fill(1.F);
+  variance.fill(0.5F);
+
+  const auto out = Linx::bin(in, variance, Linx::Position<2> {2, 3});
+
+  BOOST_TEST(out.value.extent(0) == 3);
+  BOOST_TEST(out.value.extent(1) == 2);
+  const auto value = Linx::on_host(out.value);
+  const auto var = Linx::on_host(out.variance);
+  for (int v = 0; v < 2; ++v) {
+    for (int u = 0; u < 3; ++u) {
+      BOOST_TEST(value(u, v) == 6.F);
+      BOOST_TEST(var(u, v) == 3.F);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bad_factor_test)
+{
+  Linx::Image<float, 2> in("in", 4, 3);
+  Linx::Image<float, 2> variance("variance", 3, 4);
+  BOOST_CHECK_THROW(Linx::bin(in, Linx::Position<2> {5, 1}), Linx::OutOfBounds<'[', ']'>);
+  BOOST_CHECK_THROW(Linx::bin(in, variance, Linx::Position<2> {2, 1}), Linx::OutOfBounds<'[', ']'>);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE CalibrationTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Calibration.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdint>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(calibrate_test)
+{
+  const int width = 4;
+  const int height = 3;
+  Linx::Image<std::uint16_t, 2> raw("raw", width, height);
+  Linx::Image<float, 2> bias("bias", width, height);
+  Linx::Image<float, 2> dark("dark", width, height);
+  Linx::Image<float, 2> flat("flat", width, height);
+  Linx::Image<bool, 2> mask("mask", width, height);
+  raw.fill(1100);
+  bias.fill(100.F);
+  dark.fill(2.F);
+  flat.fill(0.5F);
+  Linx::for_each(
+      "defects",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        raw(1, 0) = 60000;
+        mask(2, 1) = true;
+        flat(3, 2) = 0.F;
+      });
+
+  Linx::CalibrationParameters parameters;
+  parameters.exposure = 10;
+  parameters.gain = 2;
+  parameters.read_noise = 3;
+  parameters.saturation = 50000;
+  const auto out = Linx::calibrate(raw, bias, dark, flat, mask, parameters);
+
+  const auto value = Linx::on_host(out.value);
+  const auto variance = Linx::on_host(out.variance);
+  const auto flags = Linx::on_host(out.flags);
+  BOOST_TEST(value(0, 0) == (1100.F - 100.F - 20.F) / 0.5F);
+  BOOST_TEST(variance(0, 0) == (1000.F / 2.F + 9.F) / 0.25F);
+  BOOST_TEST(flags(0, 0) == Linx::CalibrationFlag::Valid);
+  BOOST_TEST(flags(1, 0) == Linx::CalibrationFlag::Saturated);
+  BOOST_TEST(value(1, 0) == (60000.F - 100.F - 20.F) / 0.5F);
+  BOOST_TEST(flags(2, 1) == Linx::CalibrationFlag::Bad);
+  BOOST_TEST(std::isnan(value(2, 1)));
+  BOOST_TEST(std::isinf(variance(2, 1)));
+  BOOST_TEST(flags(3, 2) == Linx::CalibrationFlag::InvalidFlat);
+  BOOST_TEST(std::isnan(value(3, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(propagate_variance_test)
+{
+  const int width = 4;
+  const int height = 3;
+  using Image = Linx::Image<float, 2>;
+  Image raw("raw", width, height);
+  Linx::WithVariance<float, 2> bias {Image("bias", width, height), Image("bias variance", width, height)};
+  Linx::WithVariance<float, 2> dark {Image("dark", width, height), Image("dark variance", width, height)};
+  Linx::WithVariance<float, 2> flat {Image("flat", width, height), Image("flat variance", width, height)};
+  Linx::Image<bool, 2> mask("mask", width, height);
+  raw.fill(1100.F);
+  bias.value.fill(100.F);
+  bias.variance.fill(4.F);
+  dark.value.fill(2.F);
+  dark.variance.fill(0.01F);
+  flat.value.fill(0.5F);
+  flat.variance.fill(0.0025F);
+
+  Linx::CalibrationParameters parameters;
+  parameters.exposure = 10;
+  parameters.gain = 2;
+  parameters.read_noise = 3;
+  const auto out = Linx::calibrate(raw, bias, dark, flat, mask, parameters);
+  const auto plain = Linx::calibrate(raw, bias.value, dark.value, flat.value, mask, parameters);
+
+  const auto value = Linx::on_host(out.value);
+  const auto variance = Linx::on_host(out.variance);
+  const auto plain_variance = Linx::on_host(plain.variance);
+  const float expected = 1960.F;
+  const float frames = 4.F + 0.01F * 100.F + expected * expected * 0.0025F;
+  for (int j = 0; j < height; ++j) {
+    for (int i = 0; i < width; ++i) {
+      BOOST_TEST(value(i, j) == expected);
+      BOOST_TEST(variance(i, j) == plain_variance(i, j) + frames / 0.25F, boost::test_tools::tolerance(1e-5F));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(size_mismatch_test)
+{
+  Linx::Image<float, 2> raw("raw", 4, 3);
+  Linx::Image<float, 2> small("small", 3, 3);
+  BOOST_CHECK_THROW(Linx::calibrate(raw, raw, raw, small, raw), Linx::SizeMismatch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
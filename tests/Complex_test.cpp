@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ComplexTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Complex.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+using Complex = Kokkos::complex<double>;
+
+Linx::Image<Complex, 2> make_image(double re, double im)
+{
+  Linx::Image<Complex, 2> out("in", 5, 4);
+  Linx::for_each(
+      "fill",
+      out.domain(),
+      KOKKOS_LAMBDA(int i, int j) { out(i, j) = Complex(re * (i + 1), im * (j - 1)); });
+  return out;
+}
+
+BOOST_AUTO_TEST_CASE(multiply_test)
+{
+  const auto a = make_image(1., 2.);
+  const auto b = make_image(-0.5, 3.);
+  const auto a_on_host = Linx::on_host(a);
+  const auto b_on_host = Linx::on_host(b);
+  const auto product = Linx::on_host(Linx::complex_multiply(a, b));
+  const auto cross = Linx::on_host(Linx::conj_multiply(a, b));
+  for (int j = 0; j < 4; ++j) {
+    for (int i = 0; i < 5; ++i) {
+      const auto expected = a_on_host(i, j) * b_on_host(i, j);
+      const auto expected_cross = a_on_host(i, j) * Kokkos::conj(b_on_host(i, j));
+      BOOST_TEST(product(i, j).real() == expected.real());
+      BOOST_TEST(product(i, j).imag() == expected.imag());
+      BOOST_TEST(cross(i, j).real() == expected_cross.real());
+      BOOST_TEST(cross(i, j).imag() == expected_cross.imag());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(polar_round_trip_test)
+{
+  const auto a = make_image(1., -2.);
+  const auto a_on_host = Linx::on_host(a);
+  const auto magnitude = Linx::magnitude(a);
+  const auto phase = Linx::phase(a);
+  const auto magnitude_on_host = Linx::on_host(magnitude);
+  const auto phase_on_host = Linx::on_host(phase);
+  const auto back = Linx::on_host(Linx::polar(magnitude, phase));
+  for (int j = 0; j < 4; ++j) {
+    for (int i = 0; i < 5; ++i) {
+      const auto value = a_on_host(i, j);
+      BOOST_TEST(
+          magnitude_on_host(i, j) == std::hypot(value.real(), value.imag()),
+          boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(phase_on_host(i, j) == std::atan2(value.imag(), value.real()), boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(back(i, j).real() == value.real(), boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(back(i, j).imag() + 1. == value.imag() + 1., boost::test_tools::tolerance(1e-12));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
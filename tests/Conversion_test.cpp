@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ConversionTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Conversion.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+template <typename T>
+std::vector<T> to_vector(const auto& in)
+{
+  const auto on_host = Linx::on_host(in);
+  return std::vector<T>(on_host.data(), on_host.data() + on_host.size());
+}
+
+BOOST_AUTO_TEST_CASE(gain_offset_round_trip_test)
+{
+  Linx::Image<std::uint16_t, 2> raw("raw", 16, 8);
+  raw.fill_with_offsets();
+  raw *= std::uint16_t(500);
+  const double gain = 1.7;
+  const double offset = -120.;
+  const auto electrons = Linx::convert_to<float>(raw, gain, offset);
+  const auto raw_values = to_vector<std::uint16_t>(raw);
+  const auto electron_values = to_vector<float>(electrons);
+  for (std::size_t i = 0; i < raw_values.size(); ++i) {
+    BOOST_TEST(electron_values[i] == raw_values[i] * gain + offset, boost::test_tools::tolerance(1e-5));
+  }
+  const auto back = Linx::convert_back_to<std::uint16_t>(electrons, gain, offset);
+  BOOST_TEST(to_vector<std::uint16_t>(back) == raw_values, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(rounding_test)
+{
+  Linx::Sequence<float, -1> values("values", {-1.5F, -0.5F, 0.5F, 1.5F, 2.7F});
+  Linx::Image<float, 1> in(Linx::Wrap(values.data()), 5);
+  using Linx::Rounding;
+  std::vector<int> nearest {-2, -1, 1, 2, 3};
+  std::vector<int> floor {-2, -1, 0, 1, 2};
+  std::vector<int> ceil {-1, 0, 1, 2, 3};
+  std::vector<int> truncate {-1, 0, 0, 1, 2};
+  BOOST_TEST(
+      to_vector<int>(Linx::convert_to<int>(in, 1, 0, Rounding::Nearest)) == nearest,
+      boost::test_tools::per_element());
+  BOOST_TEST(
+      to_vector<int>(Linx::convert_to<int>(in, 1, 0, Rounding::Floor)) == floor,
+      boost::test_tools::per_element());
+  BOOST_TEST(
+      to_vector<int>(Linx::convert_to<int>(in, 1, 0, Rounding::Ceil)) == ceil,
+      boost::test_tools::per_element());
+  BOOST_TEST(
+      to_vector<int>(Linx::convert_to<int>(in, 1, 0, Rounding::Truncate)) == truncate,
+      boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(saturation_test)
+{
+  Linx::Sequence<double, -1> values("values", {-1e6, -32768.4, 0.2, 32766.6, 1e6});
+  Linx::Image<double, 1> in(Linx::Wrap(values.data()), 5);
+  std::vector<std::int16_t> expected {-32768, -32768, 0, 32767, 32767};
+  BOOST_TEST(to_vector<std::int16_t>(Linx::convert_to<std::int16_t>(in)) == expected, boost::test_tools::per_element());
+  std::vector<std::uint8_t> bytes {0, 0, 0, 255, 255};
+  BOOST_TEST(to_vector<std::uint8_t>(Linx::convert_to<std::uint8_t>(in)) == bytes, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(wide_saturation_test)
+{
+  Linx::Sequence<double, -1> values("values", {-1e30, 1e30});
+  Linx::Image<double, 1> in(Linx::Wrap(values.data()), 2);
+  const auto signed_out = to_vector<std::int64_t>(Linx::convert_to<std::int64_t>(in));
+  BOOST_TEST(signed_out[0] == std::numeric_limits<std::int64_t>::lowest());
+  BOOST_TEST(signed_out[1] == std::numeric_limits<std::int64_t>::max() - 1023); // Largest double below 2^63
+  const auto unsigned_out = to_vector<std::uint64_t>(Linx::convert_to<std::uint64_t>(in));
+  BOOST_TEST(unsigned_out[0] == 0);
+  BOOST_TEST(unsigned_out[1] == std::numeric_limits<std::uint64_t>::max() - 2047); // Largest double below 2^64
+}
+
+BOOST_AUTO_TEST_CASE(floating_point_saturation_test)
+{
+  Linx::Sequence<float, -1> floats("floats", {std::numeric_limits<float>::quiet_NaN(), 2.5F});
+  Linx::Image<float, 1> float_in(Linx::Wrap(floats.data()), 2);
+  const auto float_out = to_vector<float>(Linx::convert_to<float>(float_in, 2, 1));
+  BOOST_TEST(std::isnan(float_out[0]));
+  BOOST_TEST(float_out[1] == 6.F);
+  Linx::Sequence<double, -1> doubles("doubles", {std::numeric_limits<double>::quiet_NaN(), -1e300, 1e300});
+  Linx::Image<double, 1> double_in(Linx::Wrap(doubles.data()), 3);
+  const auto double_out = to_vector<float>(Linx::convert_to<float>(double_in));
+  BOOST_TEST(std::isnan(double_out[0]));
+  BOOST_TEST(double_out[1] == std::numeric_limits<float>::lowest());
+  BOOST_TEST(double_out[2] == std::numeric_limits<float>::max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE CosmicTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Cosmic.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(detect_cosmic_rays_test)
+{
+  const int width = 96;
+  const int height = 80;
+  Linx::Image<float, 2> image("image", width, height);
+  Linx::for_each(
+      "sky",
+      image.domain(),
+      KOKKOS_LAMBDA(int x, int y) {
+        const float dx = x - 60.F;
+        const float dy = y - 20.F;
+        const float star = 2000.F * Kokkos::exp(-(dx * dx + dy * dy) / 8.F);
+        image(x, y) = 100.F + float((x * 7 + y * 13) % 3 - 1) + star;
+      });
+  Linx::for_each(
+      "cosmics",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        image(10, 10) = 5000.F; // Single pixel
+        image(31, 40) = 3000.F; // Pair across a tile border
+        image(32, 40) = 3000.F;
+        image(0, 0) = 4000.F; // Image corner
+      });
+
+  Linx::CosmicParameters parameters;
+  parameters.read_noise = 5;
+  const auto out = Linx::detect_cosmic_rays(image, parameters);
+
+  const auto cleaned = Linx::on_host(out.cleaned);
+  const auto mask = Linx::on_host(out.mask);
+  BOOST_TEST(mask(10, 10));
+  BOOST_TEST(mask(31, 40));
+  BOOST_TEST(mask(32, 40));
+  BOOST_TEST(mask(0, 0));
+  BOOST_TEST(not mask(60, 20)); // Star
+  BOOST_TEST(not mask(50, 50)); // Sky
+  BOOST_TEST(std::abs(cleaned(10, 10) - 100.F) <= 1.F);
+  BOOST_TEST(std::abs(cleaned(31, 40) - 100.F) <= 1.F);
+  BOOST_TEST(std::abs(cleaned(0, 0) - 100.F) <= 1.F);
+  BOOST_TEST(cleaned(60, 20) == 2100.F + float((60 * 7 + 20 * 13) % 3 - 1));
+}
+
+BOOST_AUTO_TEST_CASE(no_cosmic_test)
+{
+  Linx::Image<float, 2> image("image", 40, 30);
+  image.fill(100.F);
+  const auto out = Linx::detect_cosmic_rays(image);
+  const auto mask = Linx::on_host(out.mask);
+  const auto cleaned = Linx::on_host(out.cleaned);
+  for (int y = 0; y < 30; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      BOOST_TEST(not mask(x, y));
+      BOOST_TEST(cleaned(x, y) == 100.F);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(too_small_test)
+{
+  Linx::Image<float, 2> image("image", 8, 30);
+  BOOST_CHECK_THROW(Linx::detect_cosmic_rays(image), Linx::OutOfBounds<'[', ']'>);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE HalfPrecisionTest
+
+#include "Linx/Base/Reduction.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <boost/mpl/list.hpp>
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+using HalfTypes = boost::mpl::list<Kokkos::Experimental::half_t, Kokkos::Experimental::bhalf_t>;
+
+BOOST_AUTO_TEST_CASE(traits_test)
+{
+  static_assert(Linx::is_half<Kokkos::Experimental::half_t>());
+  static_assert(Linx::is_half<const Kokkos::Experimental::bhalf_t>());
+  static_assert(not Linx::is_half<float>());
+  static_assert(std::is_same_v<Linx::ComputeType<Kokkos::Experimental::half_t>, float>);
+  static_assert(std::is_same_v<Linx::ComputeType<double>, double>);
+  BOOST_TEST(float(Linx::Limits<Kokkos::Experimental::half_t>::max()) > 60000.F);
+  BOOST_TEST(float(Linx::Limits<Kokkos::Experimental::half_t>::min()) < -60000.F);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(arithmetic_test, T, HalfTypes)
+{
+  Linx::Image<T, 2> a("a", 4, 3);
+  a.fill(T(1.5F));
+  BOOST_TEST(a.contains_only(T(1.5F)));
+  a *= T(2);
+  a += T(1);
+  BOOST_TEST(a.contains_only(T(4)));
+  const auto b = a + a;
+  BOOST_TEST(b.contains_only(T(8)));
+  a.sqrt();
+  BOOST_TEST(a.contains_only(T(2)));
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(math_test, T, HalfTypes)
+{
+  Linx::Image<T, 1> a("a", 5);
+  a.fill_with_offsets();
+  const auto b = Linx::exp(a);
+  const auto b_on_host = Linx::on_host(b);
+  for (int i = 0; i < 5; ++i) {
+    const auto expected = std::exp(float(i));
+    BOOST_TEST(float(b_on_host(i)) == expected, boost::test_tools::tolerance(0.01F));
+  }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(float_accumulation_test, T, HalfTypes)
+{
+  const int size = 100000;
+  Linx::Image<T, 1> a("a", size);
+  a.fill(T(1));
+  const auto sum = Linx::sum(a);
+  static_assert(std::is_same_v<std::decay_t<decltype(sum)>, float>);
+  BOOST_TEST(sum == size); // Would saturate or stall with 16-bit accumulation
+  BOOST_TEST(Linx::dot(a, a) == size);
+  BOOST_TEST(float(Linx::max(a)) == 1.F);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
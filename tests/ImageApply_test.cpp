@@ -61,4 +61,36 @@ BOOST_AUTO_TEST_CASE(copy_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(dynamic_rank_test)
+{
+  Linx::Image<int, 3> a("a", 4, 3, 2);
+  Linx::Image<int, -1> b("b", 4, 3, 2);
+  a.fill_with_offsets();
+  b.fill_with_offsets();
+
+  const auto& ranked = Linx::as_static_rank<3>(b);
+  BOOST_TEST((ranked.shape() == a.shape()));
+  BOOST_TEST(ranked.data() == b.data());
+
+  a.apply(
+      "eval",
+      KOKKOS_LAMBDA(int ai) { return ai * ai + 1; });
+  b.apply(
+      "eval",
+      KOKKOS_LAMBDA(int bi) { return bi * bi + 1; });
+  Kokkos::fence();
+
+  const auto& a_on_host = Linx::on_host(a);
+  const auto& b_on_host = Linx::on_host(b);
+  for (int k = 0; k < 2; ++k) {
+    for (int j = 0; j < 3; ++j) {
+      for (int i = 0; i < 4; ++i) {
+        BOOST_TEST(b_on_host(i, j, k) == a_on_host(i, j, k));
+      }
+    }
+  }
+  BOOST_TEST(Linx::sum(b) == Linx::sum(a));
+  BOOST_TEST(Linx::dot(b, b) == Linx::dot(a, a));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include "Linx/Transforms/Correlation.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 
 LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -55,4 +56,66 @@ BOOST_AUTO_TEST_CASE(crop_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(variance_test)
+{
+  const int width = 5;
+  const int height = 4;
+  const int kernel = 3;
+  using Image = Linx::Image<float, 2>;
+  Image a("a", width, height);
+  Image v("v", width, height);
+  Image k("k", kernel, kernel);
+  a.fill(2.F);
+  v.fill(4.F);
+  k.fill(0.5F);
+  Kokkos::fence();
+
+  auto b = correlate("smooth", a, v, k);
+
+  const auto& value = Linx::on_host(b.value);
+  const auto& variance = Linx::on_host(b.variance);
+  BOOST_TEST(value.extent(0) == width - kernel + 1);
+  BOOST_TEST(value.extent(1) == height - kernel + 1);
+  for (int j = 0; j < height - kernel + 1; ++j) {
+    for (int i = 0; i < width - kernel + 1; ++i) {
+      BOOST_TEST(value(i, j) == kernel * kernel * 0.5F * 2.F);
+      BOOST_TEST(variance(i, j) == kernel * kernel * 0.25F * 4.F);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(nan_correlate_test)
+{
+  const int width = 4;
+  const int height = 3;
+  using Image = Linx::Image<float, 2>;
+  Image a("a", width, height);
+  Image k("k", 2, 2);
+  Linx::Image<bool, 2> mask("mask", width, height);
+  a.fill(1.F);
+  k.fill(1.F);
+  Linx::for_each(
+      "invalid",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        a(0, 0) = NAN;
+        a(2, 1) = 3.F;
+        mask(2, 1) = true;
+      });
+
+  auto b = nan_correlate("normalized", a, k);
+  auto c = nan_correlate("masked", a, mask, k);
+
+  const auto& b_on_host = Linx::on_host(b);
+  const auto& c_on_host = Linx::on_host(c);
+  BOOST_TEST(b_on_host(0, 0) == 1.F);
+  BOOST_TEST(b_on_host(1, 0) == 1.5F);
+  BOOST_TEST(b_on_host(0, 1) == 1.F);
+  for (int j = 0; j < height - 1; ++j) {
+    for (int i = 0; i < width - 1; ++i) {
+      BOOST_TEST(c_on_host(i, j) == 1.F);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -7,6 +7,7 @@
 #include "Linx/Transforms/RankFiltering.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 
 LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -47,4 +48,74 @@ BOOST_AUTO_TEST_CASE(crop_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(counters_test)
+{
+  const int width = 16;
+  const int height = 9;
+  Linx::Image<int, 2> a("a", width, height);
+  a.fill_with_offsets();
+
+  const auto before = Linx::counter_report().kernels["MedianFilter"];
+  auto median = Linx::median_filter("median", 1, a);
+  const auto after = Linx::counter_report().kernels["MedianFilter"];
+
+  if constexpr (Linx::instrumented) {
+    const std::uint64_t size = median.size();
+    BOOST_TEST(after.elements - before.elements == size);
+    BOOST_TEST(after.taps - before.taps == size * 9);
+    BOOST_TEST(after.sort_stops - before.sort_stops <= size * 9);
+    BOOST_TEST(after.threads > 0);
+    BOOST_TEST(after.max_per_thread >= after.min_per_thread);
+  } else {
+    BOOST_TEST(after.elements == 0);
+    BOOST_TEST(after.taps == 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(nanmedian_test)
+{
+  const int width = 5;
+  const int height = 4;
+  Linx::Image<float, 2> a("a", width, height);
+  Linx::Image<bool, 2> mask("mask", width, height);
+  a.fill(2.F);
+  Linx::for_each(
+      "invalid",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        a(1, 1) = NAN;
+        a(2, 1) = NAN;
+        a(3, 1) = NAN;
+        a(3, 3) = NAN;
+        a(1, 2) = 100.F;
+        a(2, 2) = 100.F;
+        mask(1, 3) = true;
+        mask(2, 3) = true;
+      });
+
+  auto median = Linx::nanmedian_filter("nanmedian", 1, a);
+  auto masked = Linx::nanmedian_filter("masked", 1, a, mask);
+
+  const auto& median_on_host = Linx::on_host(median);
+  const auto& masked_on_host = Linx::on_host(masked);
+  BOOST_TEST(median.extent(0) == width - 2);
+  BOOST_TEST(median.extent(1) == height - 2);
+  BOOST_TEST(median_on_host(0, 0) == 2.F); // 2, 2, 2, 2, 2, 100, 100
+  BOOST_TEST(median_on_host(1, 1) == 2.F); // 2, 2, 2, 100, 100
+  BOOST_TEST(masked_on_host(1, 1) == 100.F); // 2, 100, 100
+  for (int j = 0; j < height - 2; ++j) {
+    for (int i = 0; i < width - 2; ++i) {
+      BOOST_TEST(not std::isnan(median_on_host(i, j)));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(nanmedian_all_invalid_test)
+{
+  Linx::Image<float, 2> a("a", 3, 3);
+  a.fill(NAN);
+  auto median = Linx::nanmedian_filter("nanmedian", 1, a);
+  BOOST_TEST(std::isnan(Linx::on_host(median)(0, 0)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ImageStackingTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Stacking.h"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(median_along_each_axis_test)
+{
+  Linx::Image<float, 3> cube("cube", 4, 3, 5);
+  cube.fill_with_offsets();
+  cube.apply(
+      "scramble",
+      KOKKOS_LAMBDA(float e) { return int(e * 37) % 11; });
+  const auto cube_on_host = Linx::on_host(cube);
+
+  const auto last = Linx::median<2>(cube);
+  BOOST_TEST(last.extent(0) == 4);
+  BOOST_TEST(last.extent(1) == 3);
+  const auto last_on_host = Linx::on_host(last);
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 4; ++i) {
+      std::vector<float> line;
+      for (int k = 0; k < 5; ++k) {
+        line.push_back(cube_on_host(i, j, k));
+      }
+      BOOST_TEST(last_on_host(i, j) == Linx::median(line));
+    }
+  }
+
+  const auto first = Linx::median<0>(cube);
+  BOOST_TEST(first.extent(0) == 3);
+  BOOST_TEST(first.extent(1) == 5);
+  const auto first_on_host = Linx::on_host(first);
+  for (int k = 0; k < 5; ++k) {
+    for (int j = 0; j < 3; ++j) {
+      std::vector<float> line;
+      for (int i = 0; i < 4; ++i) {
+        line.push_back(cube_on_host(i, j, k));
+      }
+      BOOST_TEST(first_on_host(j, k) == Linx::median(line));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(clipped_mean_rejects_outliers_test)
+{
+  Linx::Image<double, 2> cube("cube", 3, 10);
+  cube.fill(1.);
+  Linx::for_each(
+      "outlier",
+      Linx::Box<1>({0}, {3}),
+      KOKKOS_LAMBDA(int i) { cube(i, 7) = 1000.; });
+  const auto mean = Linx::combine<1>(cube, Linx::Mean());
+  const auto clipped = Linx::clipped_mean<1>(cube, 3.);
+  const auto mean_on_host = Linx::on_host(mean);
+  const auto clipped_on_host = Linx::on_host(clipped);
+  for (int i = 0; i < 3; ++i) {
+    BOOST_TEST(mean_on_host(i) == 100.9);
+    BOOST_TEST(clipped_on_host(i) == 1.);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(combine_frames_test)
+{
+  std::vector<Linx::Image<float, 2>> frames;
+  for (int f = 0; f < 5; ++f) {
+    frames.emplace_back("frame", 6, 4);
+    frames.back().fill_with_offsets();
+    frames.back() += f * 10;
+  }
+  const auto median = Linx::combine(frames, Linx::Median());
+  const auto mean = Linx::combine(frames, Linx::Mean());
+  BOOST_TEST(median.extent(0) == 6);
+  BOOST_TEST(median.extent(1) == 4);
+  const auto median_on_host = Linx::on_host(median);
+  const auto mean_on_host = Linx::on_host(mean);
+  for (int j = 0; j < 4; ++j) {
+    for (int i = 0; i < 6; ++i) {
+      BOOST_TEST(median_on_host(i, j) == i + j * 6 + 20);
+      BOOST_TEST(mean_on_host(i, j) == i + j * 6 + 20);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(combine_mismatching_frames_test)
+{
+  std::vector<Linx::Image<float, 2>> frames;
+  frames.emplace_back("frame", 6, 4);
+  frames.emplace_back("transposed", 4, 6);
+  BOOST_CHECK_THROW(Linx::combine(frames, Linx::Median()), Linx::OutOfBounds<'[', ']'>);
+  frames.back() = Linx::Image<float, 2>("smaller", 6, 3);
+  BOOST_CHECK_THROW(Linx::combine(frames, Linx::Median()), Linx::SizeMismatch);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
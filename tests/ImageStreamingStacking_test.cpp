@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ImageStreamingStackingTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/StreamingStacking.h"
+
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+std::vector<Linx::Image<double, 2>> make_frames()
+{
+  std::vector<Linx::Image<double, 2>> frames;
+  for (int f = 0; f < 7; ++f) {
+    frames.emplace_back("frame", 5, 3);
+    frames.back().fill_with_offsets();
+    frames.back() *= (f % 3) + 1;
+    frames.back() += f;
+  }
+  return frames;
+}
+
+BOOST_AUTO_TEST_CASE(running_statistics_test)
+{
+  const auto frames = make_frames();
+  Linx::RunningStatistics<double, 2> stats(frames.front().shape());
+  for (const auto& frame : frames) {
+    stats.push(frame);
+  }
+  BOOST_TEST(stats.count() == 7);
+
+  const auto mean_on_host = Linx::on_host(stats.mean());
+  const auto variance_on_host = Linx::on_host(stats.variance());
+  for (int j = 0; j < 3; ++j) {
+    for (int i = 0; i < 5; ++i) {
+      std::vector<double> values;
+      for (int f = 0; f < 7; ++f) {
+        values.push_back((i + j * 5) * ((f % 3) + 1) + f);
+      }
+      double mean = 0;
+      for (auto v : values) {
+        mean += v;
+      }
+      mean /= 7;
+      double variance = 0;
+      for (auto v : values) {
+        variance += (v - mean) * (v - mean);
+      }
+      variance /= 6;
+      BOOST_TEST(mean_on_host(i, j) == mean, boost::test_tools::tolerance(1e-12));
+      BOOST_TEST(variance_on_host(i, j) == variance, boost::test_tools::tolerance(1e-12));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(combine_tiled_test)
+{
+  const auto frames = make_frames();
+  std::vector<Linx::FrameSource<double, 2>> sources;
+  for (const auto& frame : frames) {
+    sources.push_back(Linx::frame_source(frame));
+  }
+  const auto expected = Linx::on_host(Linx::combine(frames, Linx::Median()));
+  const auto shape = frames.front().shape();
+  for (int width : {2, 3}) {
+    for (int threads : {1, 3}) {
+      const auto median =
+          Linx::combine_tiled(sources, shape, Linx::Position<2> {width, 2}, Linx::Median(), threads);
+      const auto median_on_host = Linx::on_host(median);
+      for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 5; ++i) {
+          BOOST_TEST(median_on_host(i, j) == expected(i, j));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(combine_tiled_rethrows_test)
+{
+  const auto frames = make_frames();
+  std::vector<Linx::FrameSource<double, 2>> sources;
+  for (const auto& frame : frames) {
+    sources.push_back(Linx::frame_source(frame));
+  }
+  sources.push_back([](const auto&, const auto&) {
+    throw std::runtime_error("Cannot read frame");
+  });
+  BOOST_CHECK_THROW(
+      Linx::combine_tiled(sources, frames.front().shape(), Linx::Position<2> {4, 4}, Linx::Median()),
+      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE InpaintingTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Inpainting.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdint>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(inpaint_nan_test)
+{
+  const int width = 6;
+  const int height = 5;
+  Linx::Image<float, 2> image("image", width, height);
+  Linx::for_each(
+      "ramp",
+      image.domain(),
+      KOKKOS_LAMBDA(int x, int y) { image(x, y) = 10.F * x + y; });
+  Linx::for_each(
+      "holes",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        image(2, 2) = NAN;
+        image(3, 2) = INFINITY;
+      });
+
+  const auto out = Linx::on_host(Linx::inpaint(image, 1));
+
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      BOOST_TEST(std::isfinite(out(x, y)));
+      if (y != 2 || (x != 2 && x != 3)) {
+        BOOST_TEST(out(x, y) == 10.F * x + y);
+      }
+    }
+  }
+  // Inverse squared distance weighted means of the 7 valid neighbors
+  BOOST_TEST(out(2, 2) == 20.F, boost::test_tools::tolerance(1e-5F));
+  BOOST_TEST(out(3, 2) == 34.F, boost::test_tools::tolerance(1e-5F));
+}
+
+BOOST_AUTO_TEST_CASE(inpaint_mask_test)
+{
+  const int width = 5;
+  const int height = 5;
+  Linx::Image<std::uint16_t, 2> image("image", width, height);
+  Linx::Image<bool, 2> mask("mask", width, height);
+  image.fill(7);
+  Linx::for_each(
+      "bad",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        image(2, 2) = 65535;
+        mask(2, 2) = true;
+      });
+
+  const auto out = Linx::on_host(Linx::inpaint(image, mask));
+
+  BOOST_TEST(out(2, 2) == 7.F);
+  BOOST_TEST(out(0, 0) == 7.F);
+}
+
+BOOST_AUTO_TEST_CASE(no_valid_neighbor_test)
+{
+  Linx::Image<float, 2> image("image", 3, 3);
+  image.fill(NAN);
+  const auto out = Linx::on_host(Linx::inpaint(image));
+  BOOST_TEST(std::isnan(out(1, 1)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE LookupTableTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/LookupTable.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <cstdint>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(make_lut_test)
+{
+  const auto table = Linx::make_lut<std::int8_t>(KOKKOS_LAMBDA(std::int8_t e) { return e * 2; });
+  BOOST_TEST(table.size() == 256);
+  const auto table_on_host = Linx::on_host(table);
+  BOOST_TEST(table_on_host[0] == -256);
+  BOOST_TEST(table_on_host[128] == 0);
+  BOOST_TEST(table_on_host[255] == 254);
+}
+
+BOOST_AUTO_TEST_CASE(apply_lut8_test)
+{
+  Linx::Image<std::uint8_t, 2> in("in", 100, 70);
+  in.fill_with_offsets();
+  const auto out = Linx::lut(in, KOKKOS_LAMBDA(std::uint8_t e) { return std::sqrt(float(e)); });
+  const auto in_on_host = Linx::on_host(in);
+  const auto out_on_host = Linx::on_host(out);
+  for (int j = 0; j < 70; ++j) {
+    for (int i = 0; i < 100; ++i) {
+      BOOST_TEST(out_on_host(i, j) == std::sqrt(float(in_on_host(i, j))));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(apply_lut16_test)
+{
+  Linx::Image<std::int16_t, 2> in("in", 300, 200);
+  in.fill_with_offsets();
+  in -= std::int16_t(30000);
+  const auto table = Linx::make_lut<std::int16_t>(KOKKOS_LAMBDA(std::int16_t e) { return e < 0 ? -1 : 1; });
+  const auto out = Linx::apply_lut(in, table);
+  const auto in_on_host = Linx::on_host(in);
+  const auto out_on_host = Linx::on_host(out);
+  for (int j = 0; j < 200; ++j) {
+    for (int i = 0; i < 300; ++i) {
+      BOOST_TEST(out_on_host(i, j) == (in_on_host(i, j) < 0 ? -1 : 1));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(table_size_test)
+{
+  Linx::Image<std::uint16_t, 1> in("in", 10);
+  Linx::Sequence<float, -1> table("table", 256);
+  BOOST_CHECK_THROW(Linx::apply_lut(in, table), Linx::OutOfBounds<'[', ']'>);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
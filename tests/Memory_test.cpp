@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE MemoryTest
+
+#include "Linx/Base/Memory.h"
+#include "Linx/Data/Image.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <boost/test/unit_test.hpp>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(live_and_peak_test)
+{
+  auto& tracker = Linx::MemoryTracker::instance();
+  tracker.clear();
+  tracker.start();
+  const std::uint64_t size = 100 * 10 * sizeof(float);
+  {
+    Linx::Image<float, 2> a("a", 100, 10);
+    auto b = +a; // Hidden temporary
+    const auto report = Linx::memory_report();
+    std::uint64_t live = 0;
+    for (const auto& [space, labels] : report.labels) {
+      if (labels.count("a")) {
+        live += labels.at("a").live;
+        BOOST_TEST(labels.at("a").allocation_count == 1);
+      }
+      if (labels.count("copy(a)")) {
+        live += labels.at("copy(a)").live;
+      }
+    }
+    BOOST_TEST(live >= 2 * size);
+    BOOST_TEST(report.total.live >= 2 * size);
+  }
+  const auto report = Linx::memory_report();
+  tracker.stop();
+  BOOST_TEST(report.total.peak >= 2 * size);
+  for (const auto& [space, labels] : report.labels) {
+    if (labels.count("a")) {
+      BOOST_TEST(labels.at("a").live == 0);
+      BOOST_TEST(labels.at("a").deallocation_count == 1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(budget_test)
+{
+  auto& tracker = Linx::MemoryTracker::instance();
+  tracker.clear();
+  tracker.set_budget(1 << 20);
+  BOOST_TEST(tracker.enabled());
+  Linx::Image<char, 2> a("a", 512, 512);
+  BOOST_CHECK_THROW(Linx::Image<char, 2>("b", 1024, 1024), Linx::MemoryBudgetExceeded);
+  BOOST_CHECK_NO_THROW(Linx::Image<char, 2>("c", 256, 256));
+  tracker.stop();
+  BOOST_TEST(tracker.budget() == 0);
+  BOOST_CHECK_NO_THROW(Linx::Image<char, 2>("b", 1024, 1024));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE MomentsTest
+
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Transforms/Moments.h"
+
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+/**
+ * @brief Draw two elliptical Gaussian sources of flux 1000.
+ */
+Linx::Image<float, 2> make_sources()
+{
+  Linx::Image<float, 2> image("image", 48, 24);
+  Linx::for_each(
+      "sources",
+      image.domain(),
+      KOKKOS_LAMBDA(int x, int y) {
+        const float pi = 3.14159265F;
+        const float dx0 = x - 12.3F;
+        const float dy0 = y - 11.6F;
+        const float dx1 = x - 33.8F;
+        const float dy1 = y - 12.2F;
+        image(x, y) = 1000.F / (2 * pi * 1.5F * 1.5F) * Kokkos::exp(-0.5F * (dx0 * dx0 + dy0 * dy0) / 2.25F) +
+            1000.F / (2 * pi * 2.F * 1.2F) * Kokkos::exp(-0.5F * (dx1 * dx1 / 4.F + dy1 * dy1 / 1.44F));
+      });
+  return image;
+}
+
+BOOST_AUTO_TEST_CASE(unweighted_moments_test)
+{
+  const auto image = make_sources();
+  const std::vector<Linx::Box<2>> stamps {
+      Linx::Box<2>({3, 3}, {22, 22}),
+      Linx::Box<2>({24, 4}, {44, 21}),
+      Linx::Box<2>({60, 0}, {64, 4})};
+  const auto moments = Linx::on_host(Linx::measure_moments(image, stamps));
+
+  BOOST_TEST(moments.size() == 3);
+  const auto tol = boost::test_tools::tolerance(1e-2F);
+  BOOST_TEST(moments[0].valid);
+  BOOST_TEST(moments[0].flux == 1000.F, tol);
+  BOOST_TEST(moments[0].x == 12.3F, tol);
+  BOOST_TEST(moments[0].y == 11.6F, tol);
+  BOOST_TEST(moments[0].xx == 2.25F, tol);
+  BOOST_TEST(moments[0].yy == 2.25F, tol);
+  BOOST_TEST(std::abs(moments[0].xy) < 1e-2F);
+  BOOST_TEST(moments[1].valid);
+  BOOST_TEST(moments[1].flux == 1000.F, tol);
+  BOOST_TEST(moments[1].x == 33.8F, tol);
+  BOOST_TEST(moments[1].y == 12.2F, tol);
+  BOOST_TEST(moments[1].xx == 4.F, tol);
+  BOOST_TEST(moments[1].yy == 1.44F, tol);
+  BOOST_TEST(std::abs(moments[1].xy) < 1e-2F);
+  BOOST_TEST(not moments[2].valid); // Outside the image
+  BOOST_TEST(moments[2].iterations == 0);
+}
+
+BOOST_AUTO_TEST_CASE(adaptive_moments_test)
+{
+  const auto image = make_sources();
+  Linx::MomentsParameters parameters;
+  parameters.sigma = 1.5;
+  parameters.iterations = 50;
+  const auto moments = Linx::on_host(Linx::measure_moments(
+      image,
+      std::vector<std::array<double, 2>> {{12., 12.}, {34., 12.}},
+      10,
+      parameters));
+
+  const auto tol = boost::test_tools::tolerance(1e-2F);
+  for (std::size_t i = 0; i < moments.size(); ++i) {
+    BOOST_TEST(moments[i].valid);
+    BOOST_TEST(moments[i].iterations > 1);
+    BOOST_TEST(moments[i].iterations < parameters.iterations);
+    BOOST_TEST(moments[i].flux == 500.F, tol); // Half the flux at convergence
+  }
+  BOOST_TEST(moments[0].x == 12.3F, tol);
+  BOOST_TEST(moments[0].y == 11.6F, tol);
+  BOOST_TEST(moments[0].xx == 2.25F, tol);
+  BOOST_TEST(moments[0].yy == 2.25F, tol);
+  BOOST_TEST(moments[1].x == 33.8F, tol);
+  BOOST_TEST(moments[1].y == 12.2F, tol);
+  BOOST_TEST(moments[1].xx == 4.F, tol);
+  BOOST_TEST(moments[1].yy == 1.44F, tol);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ProfilerTest
+
+#include "Linx/Data/Image.h"
+#include "Linx/Run/ProgramContext.h"
+#include "Linx/Run/Profiler.h"
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+BOOST_AUTO_TEST_CASE(kernel_and_allocation_test)
+{
+  auto& profiler = Linx::Profiler::instance();
+  profiler.clear();
+  profiler.start();
+  BOOST_TEST(Linx::MemoryTracker::instance().enabled());
+  {
+    Linx::Image<int, 2> a("a", 4, 3);
+    a.fill_with_offsets();
+    a += 1;
+    a += 1;
+    Kokkos::fence();
+  }
+  profiler.stop();
+  BOOST_TEST(not Linx::MemoryTracker::instance().enabled());
+
+  const auto& kernels = profiler.kernels();
+  BOOST_TEST(kernels.count("fill_with_offsets()") == 1);
+  BOOST_TEST(kernels.at("fill_with_offsets()").count() == 1);
+  BOOST_TEST(kernels.at("+(a, 1)").count() == 2);
+  BOOST_TEST(kernels.at("+(a, 1)").percentile(100) >= kernels.at("+(a, 1)").percentile(50));
+
+  std::size_t allocation_count = 0;
+  std::size_t deallocation_count = 0;
+  for (const auto& [space, labels] : Linx::memory_report().labels) {
+    if (labels.count("a")) {
+      allocation_count += labels.at("a").allocation_count;
+      deallocation_count += labels.at("a").deallocation_count;
+      BOOST_TEST(labels.at("a").allocated >= 4 * 3 * sizeof(int));
+      BOOST_TEST(labels.at("a").peak >= 4 * 3 * sizeof(int));
+      BOOST_TEST(labels.at("a").live == 0);
+    }
+  }
+  BOOST_TEST(allocation_count == 1);
+  BOOST_TEST(deallocation_count == 1);
+
+  std::stringstream report;
+  profiler.report(report);
+  BOOST_TEST(report.str().find("+(a, 1)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(stopped_test)
+{
+  auto& profiler = Linx::Profiler::instance();
+  profiler.clear();
+  Linx::Image<int, 1> a("a", 4);
+  a.fill_with_offsets();
+  Kokkos::fence();
+  BOOST_TEST(not profiler.enabled());
+  BOOST_TEST(profiler.kernels().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
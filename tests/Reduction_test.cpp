@@ -8,6 +8,7 @@
 #include "Linx/Run/ProgramContext.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
 
 LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
 
@@ -76,4 +77,36 @@ BOOST_AUTO_TEST_CASE(norm_seq_test)
   test_norm(Linx::Sequence<int, 4>("a"));
 }
 
+BOOST_AUTO_TEST_CASE(nansum_nanmean_test)
+{
+  const int width = 4;
+  const int height = 3;
+  Linx::Image<float, 2> a("a", width, height);
+  Linx::Image<bool, 2> mask("mask", width, height);
+  Linx::for_each(
+      "range",
+      a.domain(),
+      KOKKOS_LAMBDA(int i, int j) {
+        a(i, j) = i + j * width;
+        mask(i, j) = (i == 1);
+      });
+  Linx::for_each(
+      "nans",
+      Linx::Box<1>({0}, {1}),
+      KOKKOS_LAMBDA(int) {
+        a(0, 0) = NAN;
+        a(3, 2) = INFINITY;
+      });
+
+  // Valid values are 1 to 10, and masked values are 1, 5 and 9
+  BOOST_TEST(Linx::nansum(a) == 55.F);
+  BOOST_TEST(Linx::nanmean(a) == 5.5F);
+  BOOST_TEST(Linx::nansum(a, mask) == 40.F);
+  BOOST_TEST(Linx::nanmean(a, mask) == 40.F / 7);
+
+  mask.fill(true);
+  BOOST_TEST(Linx::nansum(a, mask) == 0.F);
+  BOOST_TEST(std::isnan(Linx::nanmean(a, mask)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE ScanTest
+
+#include "Linx/Data/Image.h"
+#include "Linx/Data/Scan.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <boost/test/unit_test.hpp>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+template <typename T>
+std::vector<T> to_vector(const auto& in)
+{
+  const auto on_host = Linx::on_host(in);
+  return std::vector<T>(on_host.data(), on_host.data() + on_host.size());
+}
+
+BOOST_AUTO_TEST_CASE(sequence_sum_test)
+{
+  const int size = 10000;
+  Linx::Sequence<long, -1> a("a", size);
+  a.fill_with_offsets();
+  const auto inclusive = to_vector<long>(Linx::inclusive_scan(a, Linx::Add()));
+  const auto exclusive = to_vector<long>(Linx::exclusive_scan(a, Linx::Add()));
+  for (long i = 0; i < size; ++i) {
+    BOOST_TEST(inclusive[i] == i * (i + 1) / 2);
+    BOOST_TEST(exclusive[i] == i * (i - 1) / 2);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sequence_max_test)
+{
+  Linx::Sequence<int, -1> a("a", {3, 1, 4, 1, 5, 9, 2, 6});
+  std::vector<int> inclusive {3, 3, 4, 4, 5, 9, 9, 9};
+  BOOST_TEST(to_vector<int>(Linx::inclusive_scan(a, Linx::Max())) == inclusive, boost::test_tools::per_element());
+  const auto exclusive = to_vector<int>(Linx::exclusive_scan(a, Linx::Max()));
+  BOOST_TEST(exclusive[0] == std::numeric_limits<int>::lowest());
+  BOOST_TEST(exclusive[7] == 9);
+}
+
+BOOST_AUTO_TEST_CASE(readonly_input_test)
+{
+  Linx::Sequence<int, -1> a("a", {3, 1, 4, 1, 5});
+  auto inclusive = Linx::inclusive_scan(Linx::as_readonly(a), Linx::Add());
+  static_assert(std::is_same_v<decltype(inclusive), Linx::Sequence<int, -1>>);
+  inclusive.fill(0); // Writable
+  Linx::Image<int, 2> image("image", 3, 2);
+  image.fill(1);
+  const auto integral = Linx::on_host(Linx::inclusive_scan<1>(Linx::as_readonly(image), Linx::Add()));
+  static_assert(std::is_same_v<typename decltype(integral)::element_type, int>);
+  BOOST_TEST(integral(2, 1) == 2);
+}
+
+BOOST_AUTO_TEST_CASE(image_axes_test)
+{
+  Linx::Image<int, 3> image("image", 4, 3, 5);
+  image.fill_with_offsets();
+  const auto image_on_host = Linx::on_host(image);
+  const auto along0 = Linx::on_host(Linx::inclusive_scan<0>(image, Linx::Add()));
+  const auto along2 = Linx::on_host(Linx::exclusive_scan<2>(image, Linx::Add()));
+  for (int k = 0; k < 5; ++k) {
+    for (int j = 0; j < 3; ++j) {
+      for (int i = 0; i < 4; ++i) {
+        int sum0 = 0;
+        for (int x = 0; x <= i; ++x) {
+          sum0 += image_on_host(x, j, k);
+        }
+        int sum2 = 0;
+        for (int z = 0; z < k; ++z) {
+          sum2 += image_on_host(i, j, z);
+        }
+        BOOST_TEST(along0(i, j, k) == sum0);
+        BOOST_TEST(along2(i, j, k) == sum2);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(blocked_scan_test)
+{
+  const int length = 10007;
+  Linx::Image<long, 2> image("image", 2, length);
+  image.fill_with_offsets();
+  for (int blocks : {1, 2, 7, 64}) {
+    Linx::Image<long, 2> inclusive("inclusive", 2, length);
+    Linx::Image<long, 2> exclusive("exclusive", 2, length);
+    Linx::Impl::scan_lines<1, true>(image, inclusive, Linx::Add(), blocks);
+    Linx::Impl::scan_lines<1, false>(image, exclusive, Linx::Add(), blocks);
+    const auto inclusive_on_host = Linx::on_host(inclusive);
+    const auto exclusive_on_host = Linx::on_host(exclusive);
+    long sum0 = 0;
+    long sum1 = 0;
+    for (long j = 0; j < length; ++j) {
+      BOOST_TEST(exclusive_on_host(0, j) == sum0);
+      BOOST_TEST(exclusive_on_host(1, j) == sum1);
+      sum0 += 2 * j;
+      sum1 += 2 * j + 1;
+      BOOST_TEST(inclusive_on_host(0, j) == sum0);
+      BOOST_TEST(inclusive_on_host(1, j) == sum1);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
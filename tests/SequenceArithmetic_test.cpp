@@ -58,4 +58,16 @@ BOOST_AUTO_TEST_CASE(unary_scalar_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(lazy_label_test)
+{
+  auto a = Linx::Sequence<int, 3>("a").fill_with_offsets();
+  const int one = 1;
+  const auto label = Linx::lazy_label("+", a, one);
+  BOOST_TEST(label.label() == Linx::compose_label("+", a, one));
+  BOOST_TEST(std::string(label) == "+(a, 1)");
+  BOOST_TEST(Linx::kernel_label(label) == (Kokkos::Tools::profileLibraryLoaded() ? "+(a, 1)" : "+"));
+  a += one;
+  BOOST_TEST(a.label() == "a");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: Copyright (C) 2024, Antoine Basset
+// SPDX-License-Identifier: Apache-2.0
+
+#define BOOST_TEST_MODULE SortingTest
+
+#include "Linx/Data/Image.h"
+#include "Linx/Data/Sorting.h"
+#include "Linx/Run/ProgramContext.h"
+
+#include <algorithm>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+LINX_AUTO_TEST_SUITE(BOOST_TEST_MODULE)
+
+template <typename T>
+std::vector<T> to_vector(const auto& in)
+{
+  const auto on_host = Linx::on_host(in);
+  return std::vector<T>(on_host.data(), on_host.data() + on_host.size());
+}
+
+BOOST_AUTO_TEST_CASE(int_sort_test)
+{
+  const int size = 10000;
+  Linx::Sequence<int, -1> a("a", size);
+  a.fill_with_offsets();
+  a.apply(
+      "scramble",
+      KOKKOS_LAMBDA(int e) { return (e * 7919) % 2003 - 1000; });
+  auto expected = to_vector<int>(a);
+  std::sort(expected.begin(), expected.end());
+  Linx::sort(a);
+  BOOST_TEST(to_vector<int>(a) == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(float_sort_test)
+{
+  Linx::Sequence<float, -1> a("a", {3.5F, -0.5F, 1e30F, -1e-30F, 0.F, -2.F, 7.F, -1e30F, 2.F});
+  auto expected = to_vector<float>(a);
+  std::sort(expected.begin(), expected.end());
+  Linx::sort(a);
+  BOOST_TEST(to_vector<float>(a) == expected, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(compare_sort_test)
+{
+  Linx::Sequence<double, -1> a("a", 1000);
+  a.fill_with_offsets();
+  Linx::sort(a, Linx::Greater());
+  const auto a_on_host = to_vector<double>(a);
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_TEST(a_on_host[i] == 999 - i);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(image_sort_test)
+{
+  Linx::Image<int, 2> a("a", 40, 30);
+  a.fill_with_offsets();
+  a.reverse();
+  BOOST_TEST(not std::ranges::is_sorted(to_vector<int>(a)));
+  Linx::sort(a);
+  BOOST_TEST(std::ranges::is_sorted(to_vector<int>(a)));
+}
+
+BOOST_AUTO_TEST_CASE(sort_by_key_is_stable_test)
+{
+  const int size = 1000;
+  Linx::Sequence<int, -1> keys("keys", size);
+  Linx::Sequence<int, -1> values("values", size);
+  keys.fill_with_offsets();
+  values.fill_with_offsets();
+  keys.apply(
+      "mod",
+      KOKKOS_LAMBDA(int e) { return e % 10; });
+  Linx::sort_by_key(keys, values);
+  const auto keys_on_host = to_vector<int>(keys);
+  const auto values_on_host = to_vector<int>(values);
+  for (int i = 0; i < size; ++i) {
+    BOOST_TEST(keys_on_host[i] == i / 100);
+    BOOST_TEST(values_on_host[i] == (i % 100) * 10 + i / 100);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(argsort_test)
+{
+  Linx::Sequence<float, -1> a("a", {3.F, 1.F, 2.F, 1.F, 0.F});
+  const auto indices = Linx::argsort(a);
+  BOOST_TEST(indices.label() == "argsort(a)");
+  const std::vector<Linx::Index> expected {4, 1, 3, 2, 0};
+  BOOST_TEST(to_vector<Linx::Index>(indices) == expected, boost::test_tools::per_element());
+  const std::vector<float> unchanged {3.F, 1.F, 2.F, 1.F, 0.F};
+  BOOST_TEST(to_vector<float>(a) == unchanged, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_SUITE_END()